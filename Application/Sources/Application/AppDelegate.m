@@ -11,6 +11,7 @@
 #import "ApplicationSettingsConstants.h"
 #import "DeepLinkService.h"
 #import "Download.h"
+#import "DownloadSession.h"
 #import "Favorites.h"
 #import "GoogleCast.h"
 #import "NSBundle+PlaySRG.h"
@@ -51,6 +52,7 @@ static void *s_kvoContext = &s_kvoContext;
 {
     [AVAudioSession.sharedInstance setCategory:AVAudioSessionCategoryPlayback error:NULL];
     [RemoteCommandCenter activateRatingCommand];
+    [ImageLoader setup];
     
     PlayApplicationRunOnce(^(void (^completionHandler)(BOOL success)) {
         [PlayFirebaseConfiguration clearFirebaseConfigurationCache];
@@ -190,6 +192,12 @@ static void *s_kvoContext = &s_kvoContext;
     [PushService.sharedService updateApplicationBadge];
 }
 
+// Queued downloads are started when the system wakes the application for finished transfers
+- (void)application:(UIApplication *)application handleEventsForBackgroundURLSession:(NSString *)identifier completionHandler:(void (^)(void))completionHandler
+{
+    [DownloadSession.sharedDownloadSession handleEventsForBackgroundURLSessionWithIdentifier:identifier completionHandler:completionHandler];
+}
+
 #pragma mark SRGAnalyticsTrackerDataSource protocol
 
 - (SRGAnalyticsLabels *)srg_globalLabels
@@ -132,7 +132,7 @@ private var cancellable: AnyCancellable?
 
         private func mediaPublisher(for program: SRGProgram, in channel: SRGChannel) -> AnyPublisher<SRGMedia, Error>? {
             if program.play_containsDate(Date()) {
-                SRGDataProvider.current!.tvLivestreams(for: channel.vendor)
+                SRGDataProvider.current!.sharedTvLivestreams(for: channel.vendor)
                     .compactMap { $0.first(where: { $0.channel == channel }) }
                     .eraseToAnyPublisher()
             } else if let mediaUrn = program.mediaURN {
@@ -262,7 +262,7 @@ private var cancellable: AnyCancellable?
                     }
             } else if let showUrn = notification.showURN {
                 UserConsentHelper.waitCollectingConsentRetain()
-                cancellable = SRGDataProvider.current!.show(withUrn: showUrn)
+                cancellable = SRGDataProvider.current!.sharedShow(withUrn: showUrn)
                     .receive(on: DispatchQueue.main)
                     .sink { result in
                         if case let .failure(error) = result {
@@ -33,6 +33,15 @@ private let kDefaultNumberOfLivestreamPlaceholders = 4
 // MARK: Types
 
 enum Content {
+    /// Serial queue on which content states (rows, items) are assembled, away from the main thread
+    static let processingQueue = DispatchQueue(label: "ch.srgssr.play.content-processing", qos: .userInitiated)
+
+    /// Serial queue on which collection snapshots are built and diffed before being applied on the main thread
+    static let snapshotQueue = DispatchQueue(label: "ch.srgssr.play.content-snapshot", qos: .userInteractive)
+
+    /// Delay during which row updates are coalesced, about one display frame
+    static let rowCoalescingInterval: DispatchQueue.SchedulerTimeType.Stride = .milliseconds(16)
+
     enum Section: Hashable {
         case content(SRGContentSection, type: ContentType, show: SRGShow? = nil)
         case configured(ConfiguredSection)
@@ -186,8 +195,12 @@ protocol SectionProperties {
     /// results can be retrieved (if any) using a paginator, one page at a time.
     func publisher(pageSize: UInt, paginatedBy paginator: Trigger.Signal?, filter: SectionFiltering?) -> AnyPublisher<[Content.Item], Error>
 
-    /// Publisher for interactive updates (addition / removal of items by the user).
-    func interactiveUpdatesPublisher() -> AnyPublisher<[Content.Item], Never>
+    /// `true` iff each result delivered by the publisher is an updated version of the whole content, replacing
+    /// previously delivered results instead of being appended to them.
+    var publishesContentUpdates: Bool { get }
+
+    /// Publisher for interactive updates (addition / removal of items by the user), as change sets.
+    func interactiveUpdatesPublisher() -> AnyPublisher<ItemChangeSet<Content.Item>, Never>
 
     /// Signal which can be used to trigger a section reload.
     func reloadSignal() -> AnyPublisher<Void, Never>?
@@ -470,11 +483,11 @@ private extension Content {
                         .map { $0.map { .media($0) } }
                         .eraseToAnyPublisher()
                 case (.livestreams, .audio):
-                    return dataProvider.radioLivestreams(for: contentSection.vendor, contentProviders: .all)
+                    return dataProvider.sharedRadioLivestreams(for: contentSection.vendor, contentProviders: .all)
                         .map { $0.map { .media($0) } }
                         .eraseToAnyPublisher()
                 case (.livestreams, .video):
-                    return dataProvider.tvLivestreams(for: contentSection.vendor)
+                    return dataProvider.sharedTvLivestreams(for: contentSection.vendor)
                         .map { $0.map { .media($0) } }
                         .eraseToAnyPublisher()
                 case (.topicSelector, _):
@@ -517,7 +530,11 @@ private extension Content {
             }
         }
 
-        func interactiveUpdatesPublisher() -> AnyPublisher<[Content.Item], Never> {
+        var publishesContentUpdates: Bool {
+            contentSection.type == .predefined && presentation.type == .myProgram
+        }
+
+        func interactiveUpdatesPublisher() -> AnyPublisher<ItemChangeSet<Content.Item>, Never> {
             switch contentSection.type {
             case .predefined:
                 switch contentSection.presentation.type {
@@ -528,10 +545,10 @@ private extension Content {
                 case .watchLater, .streamLater:
                     UserInteractionSignal.watchLaterUpdates()
                 default:
-                    Just([]).eraseToAnyPublisher()
+                    Empty().eraseToAnyPublisher()
                 }
             default:
-                Just([]).eraseToAnyPublisher()
+                Empty().eraseToAnyPublisher()
             }
         }
 
@@ -1004,7 +1021,7 @@ private extension Content {
                     .map { $0.map { .media($0) } }
                     .eraseToAnyPublisher()
             case .tvLive:
-                return dataProvider.tvLivestreams(for: vendor)
+                return dataProvider.sharedTvLivestreams(for: vendor)
                     .map { $0.map { .media($0) } }
                     .eraseToAnyPublisher()
             case .tvLiveCenterScheduledLivestreams:
@@ -1058,7 +1075,15 @@ private extension Content {
             }
         }
 
-        func interactiveUpdatesPublisher() -> AnyPublisher<[Content.Item], Never> {
+        var publishesContentUpdates: Bool {
+            if case .radioLatestEpisodesFromFavorites = configuredSection {
+                true
+            } else {
+                false
+            }
+        }
+
+        func interactiveUpdatesPublisher() -> AnyPublisher<ItemChangeSet<Content.Item>, Never> {
             switch configuredSection {
             case .favoriteShows, .radioFavoriteShows, .radioLatestEpisodesFromFavorites:
                 return UserInteractionSignal.favoriteUpdates()
@@ -1073,7 +1098,7 @@ private extension Content {
                     return UserInteractionSignal.notificationUpdates()
             #endif
             default:
-                return Just([]).eraseToAnyPublisher()
+                return Empty().eraseToAnyPublisher()
             }
         }
 
@@ -0,0 +1,240 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+import Combine
+import SRGDataProviderCombine
+
+/**
+ *  Turns media URN lists into medias. Medias are kept in an in-memory cache keyed by URN, until they might change
+ *  (availability or blocking reason changes) or after a few minutes at most. URNs requested at the same time, e.g. by
+ *  several sections or screens, are merged into batches so that only missing medias are retrieved, with as few
+ *  requests as possible.
+ *
+ *  Can be used from any thread.
+ */
+@objc final class MediaHydrationService: NSObject {
+    @objc static let shared = MediaHydrationService()
+
+    private static let batchSize = 50
+    private static let batchingWindow: DispatchTimeInterval = .milliseconds(20)
+    private static let maximumTtl: TimeInterval = 5 * 60
+    private static let blockedTtl: TimeInterval = 60
+
+    private struct CacheEntry {
+        let media: SRGMedia?
+        let expirationDate: Date
+    }
+
+    private struct Waiter {
+        let urns: [String]
+        let missingUrns: Set<String>
+        let promise: (Result<[SRGMedia], Error>) -> Void
+    }
+
+    // All state is only accessed from the service queue
+    private let queue = DispatchQueue(label: "ch.srgssr.play.media-hydration")
+    private var cache = [String: CacheEntry]()
+    private var pendingUrns = Set<String>()
+    private var inFlightUrns = Set<String>()
+    private var waiters = [UUID: Waiter]()
+    private var batchCancellables = [UUID: AnyCancellable]()
+    private var isBatchScheduled = false
+
+    private var hits = 0
+    private var misses = 0
+    private var batches = 0
+
+    /**
+     *  Publishes the medias matching the specified URNs, in the same order. URNs of medias which cannot be found
+     *  are ignored.
+     */
+    func medias(withUrns urns: [String]) -> AnyPublisher<[SRGMedia], Error> {
+        guard !urns.isEmpty else {
+            return Just([])
+                .setFailureType(to: Error.self)
+                .eraseToAnyPublisher()
+        }
+
+        return Deferred {
+            let id = UUID()
+            return Future { promise in
+                self.queue.async {
+                    self.request(urns, id: id, promise: promise)
+                }
+            }
+            .handleEvents(receiveCancel: {
+                self.queue.async {
+                    self.cancel(id)
+                }
+            })
+        }
+        .eraseToAnyPublisher()
+    }
+
+    /**
+     *  Same as `medias(withUrns:)`, delivering results page by page on demand, like paginated data provider requests.
+     */
+    func medias(withUrns urns: [String], pageSize: UInt, paginatedBy paginator: Trigger.Signal?) -> AnyPublisher<[SRGMedia], Error> {
+        let pages = stride(from: 0, to: urns.count, by: Int(max(pageSize, 1))).map {
+            Array(urns[$0..<min($0 + Int(max(pageSize, 1)), urns.count)])
+        }
+        guard !pages.isEmpty else {
+            return Just([])
+                .setFailureType(to: Error.self)
+                .eraseToAnyPublisher()
+        }
+
+        return (paginator ?? Empty().eraseToAnyPublisher())
+            .prepend(())
+            .scan(-1) { index, _ in index + 1 }
+            .prefix(while: { $0 < pages.count })
+            .setFailureType(to: Error.self)
+            .flatMap(maxPublishers: .max(1)) { index in
+                self.medias(withUrns: pages[index])
+            }
+            .eraseToAnyPublisher()
+    }
+
+    /**
+     *  Objective-C variant. The completion block is called on the main thread.
+     */
+    @objc func medias(withURNs URNs: [String], completion: @escaping ([SRGMedia]?, Error?) -> Void) {
+        guard !URNs.isEmpty else {
+            DispatchQueue.main.async {
+                completion([], nil)
+            }
+            return
+        }
+
+        queue.async {
+            self.request(URNs, id: UUID()) { result in
+                DispatchQueue.main.async {
+                    switch result {
+                    case let .success(medias):
+                        completion(medias, nil)
+                    case let .failure(error):
+                        completion(nil, error)
+                    }
+                }
+            }
+        }
+    }
+
+    private static func expirationDate(for media: SRGMedia?, from date: Date) -> Date {
+        var expirationDate = date.addingTimeInterval(maximumTtl)
+        guard let media else { return expirationDate }
+
+        if media.blockingReason(at: date) != .none {
+            expirationDate = min(expirationDate, date.addingTimeInterval(blockedTtl))
+        }
+        if let startDate = media.startDate, startDate > date {
+            expirationDate = min(expirationDate, startDate)
+        }
+        if let endDate = media.endDate, endDate > date {
+            expirationDate = min(expirationDate, endDate)
+        }
+        return expirationDate
+    }
+
+    // MARK: Requests (service queue only)
+
+    private func request(_ urns: [String], id: UUID, promise: @escaping (Result<[SRGMedia], Error>) -> Void) {
+        let date = Date()
+        let missingUrns = Set(urns.filter { urn in
+            guard let entry = cache[urn] else { return true }
+            return entry.expirationDate <= date
+        })
+
+        hits += urns.count - missingUrns.count
+        misses += missingUrns.count
+
+        if missingUrns.isEmpty {
+            promise(.success(medias(for: urns)))
+        } else {
+            waiters[id] = Waiter(urns: urns, missingUrns: missingUrns, promise: promise)
+            pendingUrns.formUnion(missingUrns.subtracting(inFlightUrns))
+            scheduleBatch()
+        }
+    }
+
+    private func cancel(_ id: UUID) {
+        guard waiters.removeValue(forKey: id) != nil else { return }
+
+        // Do not request URNs which are not needed anymore. Batches already in flight are left alone, as their
+        // results are cached anyway.
+        let neededUrns = waiters.values.reduce(into: Set<String>()) { $0.formUnion($1.missingUrns) }
+        pendingUrns.formIntersection(neededUrns)
+    }
+
+    private func medias(for urns: [String]) -> [SRGMedia] {
+        urns.compactMap { cache[$0]?.media }
+    }
+
+    private func scheduleBatch() {
+        guard !isBatchScheduled, !pendingUrns.isEmpty else { return }
+        isBatchScheduled = true
+
+        // Wait a little so that URNs requested at the same time are merged into the same batches
+        queue.asyncAfter(deadline: .now() + Self.batchingWindow) {
+            self.isBatchScheduled = false
+            self.performBatches()
+        }
+    }
+
+    private func performBatches() {
+        let urns = Array(pendingUrns)
+        pendingUrns.removeAll()
+        inFlightUrns.formUnion(urns)
+
+        for startIndex in stride(from: 0, to: urns.count, by: Self.batchSize) {
+            let batchUrns = Array(urns[startIndex..<min(startIndex + Self.batchSize, urns.count)])
+            let id = UUID()
+            batches += 1
+
+            batchCancellables[id] = SRGDataProvider.current!.medias(withUrns: batchUrns, pageSize: UInt(Self.batchSize))
+                .receive(on: queue)
+                .sink { [weak self] completion in
+                    guard let self else { return }
+                    batchCancellables[id] = nil
+                    if case let .failure(error) = completion {
+                        fail(batchUrns, with: error)
+                    }
+                } receiveValue: { [weak self] medias in
+                    self?.store(medias, for: batchUrns)
+                }
+        }
+
+        PlayLogDebug(category: "mediaHydration", message: "\(urns.count) medias requested. \(hits) hits, \(misses) misses, \(batches) batches")
+    }
+
+    private func store(_ medias: [SRGMedia], for urns: [String]) {
+        let date = Date()
+        let mediasByUrn = Dictionary(medias.map { ($0.urn, $0) }, uniquingKeysWith: { first, _ in first })
+
+        // Discard expired entries
+        cache = cache.filter { $0.value.expirationDate > date }
+
+        for urn in urns {
+            let media = mediasByUrn[urn]
+            cache[urn] = CacheEntry(media: media, expirationDate: Self.expirationDate(for: media, from: date))
+        }
+        inFlightUrns.subtract(urns)
+
+        for (id, waiter) in waiters where waiter.missingUrns.allSatisfy({ cache[$0] != nil && !inFlightUrns.contains($0) && !pendingUrns.contains($0) }) {
+            waiters[id] = nil
+            waiter.promise(.success(medias(for: waiter.urns)))
+        }
+    }
+
+    private func fail(_ urns: [String], with error: Error) {
+        inFlightUrns.subtract(urns)
+
+        for (id, waiter) in waiters where !waiter.missingUrns.isDisjoint(with: urns) {
+            waiters[id] = nil
+            waiter.promise(.failure(error))
+        }
+    }
+}
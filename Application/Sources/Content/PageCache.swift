@@ -0,0 +1,156 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+import Combine
+import SRGDataProviderModel
+
+/**
+ *  Disk cache of the last rows successfully loaded for content pages, so that pages can be displayed immediately
+ *  when opened (e.g. at launch) while being revalidated.
+ *
+ *  Only rows of editorial content sections made of medias, shows or topics are cached. Other sections, notably
+ *  predefined sections driven by user data, are displayed with placeholders until loaded, as usual.
+ */
+enum PageCache {
+    private static let queue = DispatchQueue(label: "ch.srgssr.play.page-cache", qos: .userInitiated)
+
+    private static let directoryUrl: URL = {
+        let cachesDirectoryUrl = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask).first!
+        return cachesDirectoryUrl.appendingPathComponent("PageCache", isDirectory: true)
+    }()
+
+    /**
+     *  Publishes the state last saved for the specified page, or `nil` if none. The file is read in the background.
+     */
+    static func state(for id: PageViewModel.Id) -> AnyPublisher<PageViewModel.State?, Never> {
+        Deferred {
+            Future { promise in
+                queue.async {
+                    promise(.success(cachedState(for: id)))
+                }
+            }
+        }
+        .eraseToAnyPublisher()
+    }
+
+    private static func cachedState(for id: PageViewModel.Id) -> PageViewModel.State? {
+        guard let fileUrl = fileUrl(for: id), let data = try? Data(contentsOf: fileUrl) else { return nil }
+
+        let unarchivedObject: Any?
+        do {
+            let unarchiver = try NSKeyedUnarchiver(forReadingFrom: data)
+            unarchiver.requiresSecureCoding = false
+            unarchivedObject = unarchiver.decodeObject(forKey: NSKeyedArchiveRootObjectKey)
+        } catch {
+            PlayLogWarning(category: "pageCache", message: "Could not read cached page. Reason: \(error)")
+            return nil
+        }
+
+        guard let archive = unarchivedObject as? [String: Any], let rowArchives = archive["rows"] as? [[String: Any]] else { return nil }
+        let rows = rowArchives.compactMap { row(from: $0) }
+        guard !rows.isEmpty else { return nil }
+        return .loaded(rows: rows, pageUid: archive["pageUid"] as? String)
+    }
+
+    /**
+     *  Save the rows of a loaded page state in the background. Other states are ignored.
+     */
+    static func save(_ state: PageViewModel.State, for id: PageViewModel.Id) {
+        guard case let .loaded(rows: rows, pageUid: pageUid) = state, let fileUrl = fileUrl(for: id) else { return }
+
+        let rowArchives = rows.compactMap { rowArchive(from: $0) }
+        guard !rowArchives.isEmpty else { return }
+
+        var archive: [String: Any] = ["rows": rowArchives]
+        archive["pageUid"] = pageUid
+
+        queue.async {
+            do {
+                let data = try NSKeyedArchiver.archivedData(withRootObject: archive, requiringSecureCoding: false)
+                try FileManager.default.createDirectory(at: directoryUrl, withIntermediateDirectories: true)
+                try data.write(to: fileUrl, options: .atomic)
+            } catch {
+                PlayLogWarning(category: "pageCache", message: "Could not save page to cache. Reason: \(error)")
+            }
+        }
+    }
+
+    private static func fileUrl(for id: PageViewModel.Id) -> URL? {
+        let key: String? = switch id {
+        case .video:
+            "video"
+        case let .audio(channel: channel):
+            "audio-\(channel?.uid ?? "all")"
+        case let .topic(topic):
+            "topic-\(topic.urn)"
+        case let .page(page):
+            "page-\(page.uid)"
+        case .live, .show:
+            nil
+        }
+        guard let fileName = key?.addingPercentEncoding(withAllowedCharacters: .alphanumerics) else { return nil }
+        return directoryUrl.appendingPathComponent(fileName).appendingPathExtension("archive")
+    }
+
+    private static func rowArchive(from row: PageViewModel.Row) -> [String: Any]? {
+        // Predefined sections display user data, which must not be displayed again after logout or an account switch
+        guard case let .content(contentSection, type: type, show: nil) = row.section.wrappedValue,
+              contentSection.type != .predefined else {
+            return nil
+        }
+
+        var objects = [NSObject]()
+        for item in row.items {
+            switch item.wrappedValue {
+            case let .item(.media(media)):
+                objects.append(media)
+            case let .item(.show(show)):
+                objects.append(show)
+            case let .item(.topic(topic)):
+                objects.append(topic)
+            case .more:
+                continue
+            default:
+                // Placeholders and other items are not cached
+                return nil
+            }
+        }
+        guard !objects.isEmpty else { return nil }
+
+        return [
+            "section": contentSection,
+            "type": type.rawValue,
+            "index": row.section.index,
+            "objects": objects
+        ]
+    }
+
+    private static func row(from rowArchive: [String: Any]) -> PageViewModel.Row? {
+        // Also discard predefined sections saved by former versions
+        guard let contentSection = rowArchive["section"] as? SRGContentSection, contentSection.type != .predefined,
+              let typeValue = rowArchive["type"] as? Int, let type = ContentType(rawValue: typeValue),
+              let index = rowArchive["index"] as? Int,
+              let objects = rowArchive["objects"] as? [NSObject] else {
+            return nil
+        }
+
+        let items: [Content.Item] = objects.compactMap { object in
+            if let media = object as? SRGMedia {
+                .media(media)
+            } else if let show = object as? SRGShow {
+                .show(show)
+            } else if let topic = object as? SRGTopic {
+                .topic(topic)
+            } else {
+                nil
+            }
+        }
+        guard !items.isEmpty else { return nil }
+
+        let section = PageViewModel.Section(.content(contentSection, type: type), index: index)
+        return PageViewModel.Row(section: section, items: PageViewModel.rowItems(items, in: section))
+    }
+}
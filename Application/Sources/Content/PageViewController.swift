@@ -5,6 +5,7 @@
 //
 
 import Combine
+import os
 import SRGAppearanceSwift
 import SwiftUI
 import UIKit
@@ -43,6 +44,11 @@ final class PageViewController: UIViewController {
     #endif
 
     private var analyticsPageViewTracked = false
+    private let imagePrefetcher = ContentImagePrefetcher()
+
+    /// Signposts measuring main thread time spent to load and update pages (visible in Instruments)
+    private static let signpostLog = OSLog(subsystem: Bundle.main.bundleIdentifier ?? "ch.srgssr.play", category: "PageLoad")
+    private var pageLoadSignpostId: OSSignpostID?
 
     private static func snapshot(from state: PageViewModel.State) -> NSDiffableDataSourceSnapshot<PageViewModel.Section, PageViewModel.Item> {
         var snapshot = NSDiffableDataSourceSnapshot<PageViewModel.Section, PageViewModel.Item>()
@@ -105,6 +111,7 @@ final class PageViewController: UIViewController {
 
         let collectionView = CollectionView(frame: .zero, collectionViewLayout: layout(for: model))
         collectionView.delegate = self
+        collectionView.prefetchDataSource = self
         collectionView.backgroundColor = .clear
         view.addSubview(collectionView)
         self.collectionView = collectionView
@@ -303,6 +310,12 @@ final class PageViewController: UIViewController {
     }
 
     private func reloadData(for state: PageViewModel.State) {
+        let signpostId = OSSignpostID(log: Self.signpostLog)
+        os_signpost(.begin, log: Self.signpostLog, name: "Main thread update", signpostID: signpostId)
+        defer {
+            os_signpost(.end, log: Self.signpostLog, name: "Main thread update", signpostID: signpostId)
+        }
+
         switch state {
         case .loading:
             emptyContentView.content = EmptyContentView(state: .loading, insets: emptyViewEdgeInsets())
@@ -318,9 +331,22 @@ final class PageViewController: UIViewController {
             topicGradientView.content = nil
         }
 
-        DispatchQueue.global(qos: .userInteractive).async {
-            // Can be triggered on a background thread. Layout is updated on the main thread.
+        let isLoaded = if case .loaded = state { true } else { false }
+        if !isLoaded, pageLoadSignpostId == nil {
+            let pageLoadSignpostId = OSSignpostID(log: Self.signpostLog)
+            os_signpost(.begin, log: Self.signpostLog, name: "Page load", signpostID: pageLoadSignpostId)
+            self.pageLoadSignpostId = pageLoadSignpostId
+        }
+
+        Content.snapshotQueue.async {
+            // Can be triggered on a background thread (always the same one). The snapshot is built and diffed on
+            // this thread, layout is updated on the main thread.
             self.dataSource.apply(Self.snapshot(from: state)) {
+                if isLoaded, let pageLoadSignpostId = self.pageLoadSignpostId {
+                    os_signpost(.end, log: Self.signpostLog, name: "Page load", signpostID: pageLoadSignpostId)
+                    self.pageLoadSignpostId = nil
+                }
+
                 #if os(iOS)
                     // Avoid stopping scrolling
                     // See http://stackoverflow.com/a/31681037/760435
@@ -522,6 +548,10 @@ extension PageViewController: ScrollableContent {
 }
 
 extension PageViewController: UICollectionViewDelegate {
+    func collectionView(_: UICollectionView, willDisplay _: UICollectionViewCell, forItemAt indexPath: IndexPath) {
+        prefetchRowItems(after: indexPath)
+    }
+
     #if os(iOS)
         func collectionView(_: UICollectionView, didSelectItemAt indexPath: IndexPath) {
             let snapshot = dataSource.snapshot()
@@ -622,6 +652,72 @@ extension PageViewController: UICollectionViewDelegate {
     #endif
 }
 
+extension PageViewController: UICollectionViewDataSourcePrefetching {
+    func collectionView(_: UICollectionView, prefetchItemsAt indexPaths: [IndexPath]) {
+        imagePrefetcher.startPrefetching(with: imageUrls(at: indexPaths))
+    }
+
+    func collectionView(_: UICollectionView, cancelPrefetchingForItemsAt indexPaths: [IndexPath]) {
+        imagePrefetcher.stopPrefetching(with: imageUrls(at: indexPaths))
+    }
+
+    /// Images of the items following a displayed item in the same row, for swimlanes to be scrolled horizontally
+    private static let numberOfPrefetchedRowItems = 3
+
+    private func prefetchRowItems(after indexPath: IndexPath) {
+        let numberOfItems = collectionView.numberOfItems(inSection: indexPath.section)
+        let endIndex = min(indexPath.item + 1 + Self.numberOfPrefetchedRowItems, numberOfItems)
+        guard indexPath.item + 1 < endIndex else { return }
+
+        let indexPaths = (indexPath.item + 1..<endIndex).map { IndexPath(item: $0, section: indexPath.section) }
+        imagePrefetcher.startPrefetching(with: imageUrls(at: indexPaths))
+    }
+
+    private func imageUrls(at indexPaths: [IndexPath]) -> [URL] {
+        indexPaths.compactMap { indexPath in
+            guard let item = dataSource.itemIdentifier(for: indexPath) else { return nil }
+            return Self.imageUrl(for: item)
+        }
+    }
+
+    /// The image URL which the cell displaying an item will request, matching its layout
+    private static func imageUrl(for item: PageViewModel.Item) -> URL? {
+        guard case let .item(wrappedItem) = item.wrappedValue else { return nil }
+
+        let section = item.section
+        switch wrappedItem {
+        case let .media(media):
+            switch section.viewModelProperties.layout {
+            case .heroStage:
+                return MediaVisualViewModel.imageUrl(for: media, size: .large, forceDefaultAspectRatio: true)
+            case .headline, .element, .elementSwimlane:
+                return MediaVisualViewModel.imageUrl(for: media, size: .medium, forceDefaultAspectRatio: false)
+            case .liveMediaSwimlane, .liveMediaGrid:
+                return url(for: media.image, size: .small)
+            case .liveAudioSwimlane:
+                return nil
+            default:
+                return MediaVisualViewModel.imageUrl(for: media, size: .small, forceDefaultAspectRatio: false)
+            }
+        case let .show(show):
+            switch section.viewModelProperties.layout {
+            case .heroStage, .headline, .element:
+                return ShowVisualView.imageUrl(for: show, size: .medium)
+            default:
+                let imageVariant = section.properties.imageVariant
+                let aspectRatio = constant(iOS: ShowCellSize.aspectRatio(for: imageVariant, isSwimlane: true), tvOS: 16 / 9)
+                return ShowVisualView.imageUrl(for: show, size: .small, imageVariant: imageVariant, aspectRatio: aspectRatio)
+            }
+        case let .topic(topic):
+            return url(for: topic.image, size: .small)
+        case let .highlight(highlight, _):
+            return url(for: highlight.image, size: .large)
+        default:
+            return nil
+        }
+    }
+}
+
 extension PageViewController: UIScrollViewDelegate {
     #if os(iOS)
         func scrollViewDidEndDecelerating(_: UIScrollView) {
@@ -642,6 +738,8 @@ extension PageViewController: UIScrollViewDelegate {
     func scrollViewDidScroll(_ scrollView: UIScrollView) {
         guard scrollView.contentSize.height > 0 else { return }
 
+        imagePrefetcher.updateOffset(scrollView.contentOffset.y)
+
         let numberOfScreens = 4
         if scrollView.contentOffset.y > scrollView.contentSize.height - CGFloat(numberOfScreens) * scrollView.frame.height {
             model.loadMore()
@@ -18,36 +18,58 @@ final class PageViewModel: Identifiable, ObservableObject {
     @Published private(set) var displayedShow: SRGShow?
 
     private let trigger = Trigger()
+    private var cancellables = Set<AnyCancellable>()
 
     init(id: Id) {
         self.id = id
 
-        Publishers.Publish(onOutputFrom: reloadSignal()) { [weak self] in
-            Self.pagePublisher(id: id)
-                .map { page in
-                    Publishers.AccumulateLatestMany(page.sections.map { section in
-                        Publishers.PublishAndRepeat(onOutputFrom: Self.rowReloadSignal(for: section, trigger: self?.trigger)) {
-                            Self.rowPublisher(id: id,
-                                              section: section,
-                                              pageSize: Self.pageSize(for: section, in: page.sections),
-                                              paginatedBy: self?.trigger.signal(activatedBy: TriggerId.loadMore(section: section)))
-                                .replaceError(with: Self.fallbackRow(for: section, state: self?.state))
-                                .prepend(Self.placeholderRow(for: section, state: self?.state))
+        // Display the rows last loaded, if any, while the page is being revalidated
+        PageCache.state(for: id)
+            .receive(on: DispatchQueue.main)
+            .handleEvents(receiveOutput: { [weak self] cachedState in
+                guard let self, let cachedState else { return }
+                state = cachedState
+            })
+            .map { [weak self] _ in
+                Publishers.Publish(onOutputFrom: self?.reloadSignal() ?? Empty<Void, Never>().eraseToAnyPublisher()) { [weak self] in
+                    Self.pagePublisher(id: id)
+                        .map { page in
+                            Publishers.AccumulateLatestMany(page.sections.map { section in
+                                Publishers.PublishAndRepeat(onOutputFrom: Self.rowReloadSignal(for: section, trigger: self?.trigger)) {
+                                    Self.rowPublisher(id: id,
+                                                      section: section,
+                                                      pageSize: Self.pageSize(for: section, in: page.sections),
+                                                      paginatedBy: self?.trigger.signal(activatedBy: TriggerId.loadMore(section: section)))
+                                        .replaceError(with: Self.fallbackRow(for: section, state: self?.state))
+                                        .prepend(Self.placeholderRow(for: section, state: self?.state))
+                                }
+                            })
+                            // Rows are received at once at startup. Only assemble a state once per display frame.
+                            .receive(on: Content.processingQueue)
+                            .throttle(for: Content.rowCoalescingInterval, scheduler: Content.processingQueue, latest: true)
+                            .map { (page, $0) }
+                            .eraseToAnyPublisher()
+                        }
+                        .switchToLatest()
+                        .map { page, rows in
+                            State.loaded(rows: rows.filter { !$0.isEmpty }, pageUid: page.uid)
+                        }
+                        .catch { error in
+                            Just(State.failed(error: error, pageUid: self?.state.pageUid))
                         }
-                    })
-                    .map { (page, $0) }
-                    .eraseToAnyPublisher()
-                }
-                .switchToLatest()
-                .map { page, rows in
-                    State.loaded(rows: rows.filter { !$0.isEmpty }, pageUid: page.uid)
-                }
-                .catch { error in
-                    Just(State.failed(error: error, pageUid: self?.state.pageUid))
                 }
-        }
-        .receive(on: DispatchQueue.main)
-        .assign(to: &$state)
+            }
+            .switchToLatest()
+            .receive(on: DispatchQueue.main)
+            .assign(to: &$state)
+
+        $state
+            .dropFirst()
+            .debounce(for: .seconds(2), scheduler: DispatchQueue.main)
+            .sink { state in
+                PageCache.save(state, for: id)
+            }
+            .store(in: &cancellables)
 
         Publishers.PublishAndRepeat(onOutputFrom: reloadSignal()) {
             URLSession.shared.dataTaskPublisher(for: ApplicationConfiguration.shared.serviceMessageUrl)
@@ -65,7 +87,7 @@ final class PageViewModel: Identifiable, ObservableObject {
             displayedShow = show
 
             // The show page needs `topics` which could be available only in the show request.
-            SRGDataProvider.current!.show(withUrn: show.urn)
+            SRGDataProvider.current!.sharedShow(withUrn: show.urn)
                 .map { $0 }
                 .replaceError(with: show)
                 .receive(on: DispatchQueue.main)
@@ -605,19 +627,11 @@ private extension PageViewModel {
                 }
                 .eraseToAnyPublisher()
         } else {
-            Publishers.CombineLatest(
-                section.properties.publisher(pageSize: pageSize, paginatedBy: paginator, filter: id)
-                    .scan([]) { $0 + $1 },
-                section.properties.interactiveUpdatesPublisher()
-                    .prepend(Just([]))
-                    .setFailureType(to: Error.self)
-            )
-            .map { items, removedItems in
-                items.filter { !removedItems.contains($0) }
-            }
-            .map { rowItems(removeDuplicates(in: $0), in: section) }
-            .map { Row(section: section, items: $0) }
-            .eraseToAnyPublisher()
+            section.properties.publisher(pageSize: pageSize, paginatedBy: paginator, filter: id)
+                .accumulateItems(applying: section.properties.interactiveUpdatesPublisher(), replacingPages: section.properties.publishesContentUpdates)
+                .map { rowItems($0, in: section) }
+                .map { Row(section: section, items: $0) }
+                .eraseToAnyPublisher()
         }
     }
 
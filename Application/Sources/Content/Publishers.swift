@@ -23,21 +23,85 @@ extension NotificationCenter {
     }
 }
 
+// MARK: Coalesced requests
+
 extension SRGDataProvider {
-    /// Publishes the latest 30 episodes for a show URN list.
+    /// Delay during which results of idempotent lookups are shared between identical requests.
+    private static let coalescingTtl: TimeInterval = 10
+
+    /// Publishes TV livestreams, sharing identical requests made at the same time.
+    func sharedTvLivestreams(for vendor: SRGVendor) -> AnyPublisher<[SRGMedia], Error> {
+        RequestGateway.shared.publisher(for: "tvLivestreams-\(vendor.rawValue)", ttl: Self.coalescingTtl) {
+            self.tvLivestreams(for: vendor)
+        }
+    }
+
+    /// Publishes radio livestreams, sharing identical requests made at the same time.
+    func sharedRadioLivestreams(for vendor: SRGVendor, contentProviders: SRGContentProviders = .default) -> AnyPublisher<[SRGMedia], Error> {
+        RequestGateway.shared.publisher(for: "radioLivestreams-\(vendor.rawValue)-\(contentProviders.rawValue)", ttl: Self.coalescingTtl) {
+            self.radioLivestreams(for: vendor, contentProviders: contentProviders)
+        }
+    }
+
+    /// Publishes radio livestreams for a channel, sharing identical requests made at the same time.
+    func sharedRadioLivestreams(for vendor: SRGVendor, channelUid: String) -> AnyPublisher<[SRGMedia], Error> {
+        RequestGateway.shared.publisher(for: "radioLivestreams-\(vendor.rawValue)-\(channelUid)", ttl: Self.coalescingTtl) {
+            self.radioLivestreams(for: vendor, channelUid: channelUid)
+        }
+    }
+
+    /// Publishes a show, sharing identical requests made at the same time.
+    func sharedShow(withUrn urn: String) -> AnyPublisher<SRGShow, Error> {
+        RequestGateway.shared.publisher(for: "show-\(urn)", ttl: Self.coalescingTtl) {
+            self.show(withUrn: urn)
+        }
+    }
+}
+
+extension SRGDataProvider {
+    /// Publishes the latest episodes for a show URN list, sorted by publication date. Shows are requested in chunks, all
+    /// in parallel, and the merged list is published each time a chunk is received, so that the first results are
+    /// displayed without waiting for all requests to complete. Each list replaces the previous one.
     func latestMediasForShowsPublisher(withUrns urns: [String], pageSize: UInt = SRGDataProviderDefaultPageSize) -> AnyPublisher<[SRGMedia], Error> {
-        urns.publisher
+        guard !urns.isEmpty else {
+            return Just([])
+                .setFailureType(to: Error.self)
+                .eraseToAnyPublisher()
+        }
+
+        let limit = Int(pageSize)
+        return urns.publisher
             .collect(3)
             .flatMap { urns in
                 self.latestMediasForShows(withUrns: urns, filter: .episodesOnly, pageSize: 15)
+                    .map { $0.sorted(by: { $0.publicationDate > $1.publicationDate }) }
             }
-            .reduce([]) { $0 + $1 }
-            .map { medias in
-                Array(medias.sorted(by: { $0.publicationDate > $1.publicationDate }).prefix(Int(pageSize)))
+            .scan([SRGMedia]()) { medias, chunkMedias in
+                Self.mergedMedias(medias, chunkMedias, limit: limit)
             }
+            .removeDuplicates()
             .eraseToAnyPublisher()
     }
 
+    /// Merges two media lists sorted by descending publication date, keeping at most `limit` items.
+    private static func mergedMedias(_ medias1: [SRGMedia], _ medias2: [SRGMedia], limit: Int) -> [SRGMedia] {
+        var medias = [SRGMedia]()
+        medias.reserveCapacity(min(medias1.count + medias2.count, limit))
+
+        var index1 = medias1.startIndex
+        var index2 = medias2.startIndex
+        while medias.count < limit, index1 < medias1.endIndex || index2 < medias2.endIndex {
+            if index2 == medias2.endIndex || (index1 < medias1.endIndex && medias1[index1].publicationDate >= medias2[index2].publicationDate) {
+                medias.append(medias1[index1])
+                index1 += 1
+            } else {
+                medias.append(medias2[index2])
+                index2 += 1
+            }
+        }
+        return medias
+    }
+
     #if os(iOS)
         /// Publishes the regional media which corresponds to the specified media, if any.
         private func regionalizedRadioLivestreamMedia(for media: SRGMedia) -> AnyPublisher<SRGMedia, Never> {
@@ -48,7 +112,7 @@ extension SRGDataProvider {
             } else if let channelUid = media.channel?.uid,
                       let selectedLivestreamUrn = ApplicationSettingSelectedLivestreamURNForChannelUid(channelUid),
                       media.urn != selectedLivestreamUrn {
-                radioLivestreams(for: media.vendor, channelUid: channelUid)
+                sharedRadioLivestreams(for: media.vendor, channelUid: channelUid)
                     .map { medias in
                         if let selectedMedia = ApplicationSettingSelectedLivestreamMediaForChannelUid(channelUid, medias) {
                             selectedMedia
@@ -69,7 +133,7 @@ extension SRGDataProvider {
     /// are retrieved.
     func regionalizedRadioLivestreams(for vendor: SRGVendor, contentProviders: SRGContentProviders = .default) -> AnyPublisher<[SRGMedia], Error> {
         #if os(iOS)
-            return radioLivestreams(for: vendor, contentProviders: contentProviders)
+            return sharedRadioLivestreams(for: vendor, contentProviders: contentProviders)
                 .map { medias in
                     Publishers.AccumulateLatestMany(medias.map { media in
                         self.regionalizedRadioLivestreamMedia(for: media)
@@ -80,7 +144,7 @@ extension SRGDataProvider {
                 .switchToLatest()
                 .eraseToAnyPublisher()
         #else
-            return radioLivestreams(for: vendor, contentProviders: contentProviders)
+            return sharedRadioLivestreams(for: vendor, contentProviders: contentProviders)
                 .eraseToAnyPublisher()
         #endif
     }
@@ -106,7 +170,7 @@ extension SRGDataProvider {
     func historyPublisher(pageSize: UInt = SRGDataProviderDefaultPageSize, paginatedBy paginator: Trigger.Signal?, filter: SectionFiltering?) -> AnyPublisher<[SRGMedia], Error> {
         historyEntriesPublisher()
             .map { urns in
-                self.medias(withUrns: urns, pageSize: pageSize, paginatedBy: paginator)
+                MediaHydrationService.shared.medias(withUrns: urns, pageSize: pageSize, paginatedBy: paginator)
                     .map { filter?.compatibleMedias($0) ?? $0 }
             }
             .switchToLatest()
@@ -141,7 +205,7 @@ extension SRGDataProvider {
             }
         }
         .map { playbackPositions in
-            self.medias(withUrns: Array(playbackPositions.keys), pageSize: pageSize, paginatedBy: paginator)
+            MediaHydrationService.shared.medias(withUrns: Array(playbackPositions.keys), pageSize: pageSize, paginatedBy: paginator)
                 .map { filter?.compatibleMedias($0) ?? $0 }
                 .map {
                     $0.filter { media in
@@ -175,7 +239,7 @@ extension SRGDataProvider {
     func laterPublisher(pageSize: UInt = SRGDataProviderDefaultPageSize, paginatedBy paginator: Trigger.Signal?, filter: SectionFiltering?) -> AnyPublisher<[SRGMedia], Error> {
         laterEntriesPublisher()
             .map { urns in
-                self.medias(withUrns: urns, pageSize: pageSize, paginatedBy: paginator)
+                MediaHydrationService.shared.medias(withUrns: urns, pageSize: pageSize, paginatedBy: paginator)
                     .map { filter?.compatibleMedias($0) ?? $0 }
             }
             .switchToLatest()
@@ -183,18 +247,20 @@ extension SRGDataProvider {
     }
 
     func showsPublisher(withUrns urns: [String]) -> AnyPublisher<[SRGShow], Error> {
-        let trigger = Trigger()
-
-        return shows(withUrns: urns, pageSize: 50 /* Use largest page size */, paginatedBy: trigger.signal(activatedBy: 1))
-            .handleEvents(receiveOutput: { _ in
-                // FIXME: There is probably a better way
-                DispatchQueue.main.asyncAfter(deadline: .now() + 0.01) {
-                    trigger.activate(for: 1)
-                }
-            })
-            .reduce([]) { $0 + $1 }
-            .map { $0.sorted { $0.title.localizedCaseInsensitiveCompare($1.title) == .orderedAscending } }
-            .eraseToAnyPublisher()
+        RequestGateway.shared.publisher(for: "shows-\(urns.joined(separator: ","))", ttl: Self.coalescingTtl) {
+            let trigger = Trigger()
+
+            return self.shows(withUrns: urns, pageSize: 50 /* Use largest page size */, paginatedBy: trigger.signal(activatedBy: 1))
+                .handleEvents(receiveOutput: { _ in
+                    // FIXME: There is probably a better way
+                    DispatchQueue.main.asyncAfter(deadline: .now() + 0.01) {
+                        trigger.activate(for: 1)
+                    }
+                })
+                .reduce([]) { $0 + $1 }
+                .map { $0.sorted { $0.title.localizedCaseInsensitiveCompare($1.title) == .orderedAscending } }
+                .eraseToAnyPublisher()
+        }
     }
 
     func favoritesPublisher(filter: SectionFiltering?) -> AnyPublisher<[SRGShow], Error> {
@@ -203,22 +269,156 @@ extension SRGDataProvider {
             .eraseToAnyPublisher()
     }
 
+    /// Delay during which program lists are shared, so that days prefetched in the background can be displayed
+    /// without additional requests.
+    private static let programsTtl: TimeInterval = 5 * 60
+
+    /// Publishes the TV programs of the main provider, or of the other configured bouquets. Other bouquets are
+    /// requested concurrently and the list is published each time a bouquet is received, in the configured order.
     func tvProgramsPublisher(day: SRGDay? = nil, mainProvider: Bool, minimal: Bool = false) -> AnyPublisher<[PlayProgramComposition], Error> {
         let applicationConfiguration = ApplicationConfiguration.shared
         if mainProvider {
-            return SRGDataProvider.current!.tvPrograms(for: applicationConfiguration.vendor, day: day, minimal: minimal)
-                .map { Array($0.map { PlayProgramComposition(channel: $0.channel, programs: $0.programs, external: false) }) }
-                .eraseToAnyPublisher()
+            return cachedTvProgramsPublisher(for: Self.programGuideCacheKey(for: nil), day: day, minimal: minimal) {
+                RequestGateway.shared.publisher(for: Self.programsKey(for: "main", day: day, minimal: minimal), ttl: Self.programsTtl) {
+                    SRGDataProvider.current!.tvPrograms(for: applicationConfiguration.vendor, day: day, minimal: minimal)
+                        .map { Array($0.map { PlayProgramComposition(channel: $0.channel, programs: $0.programs, external: false) }) }
+                        .eraseToAnyPublisher()
+                }
+            }
         } else {
-            let tvOtherPartyProgramsPublishers = applicationConfiguration.tvGuideOtherBouquets
-                .map { tvOtherPartyProgramsPublisher(day: day, bouquet: $0, minimal: minimal) }
-            return Publishers.concatenateMany(tvOtherPartyProgramsPublishers)
-                .tryReduce([]) { $0 + $1 }
+            let bouquets = applicationConfiguration.tvGuideOtherBouquets
+            guard !bouquets.isEmpty else {
+                return Just([])
+                    .setFailureType(to: Error.self)
+                    .eraseToAnyPublisher()
+            }
+
+            let tvOtherPartyProgramsPublishers = bouquets.enumerated().map { index, bouquet in
+                tvOtherPartyProgramsPublisher(day: day, bouquet: bouquet, minimal: minimal)
+                    .map { (index: index, programCompositions: $0) }
+            }
+            return Publishers.MergeMany(tvOtherPartyProgramsPublishers)
+                .scan([[PlayProgramComposition]?](repeating: nil, count: bouquets.count)) { programCompositionsList, result in
+                    var programCompositionsList = programCompositionsList
+                    programCompositionsList[result.index] = result.programCompositions
+                    return programCompositionsList
+                }
+                .map { $0.compactMap { $0 }.flatMap { $0 } }
                 .eraseToAnyPublisher()
         }
     }
 
+    /// Loads the TV programs of a day in the background, so that they are readily available when displayed. Must be
+    /// called from the main thread.
+    func prefetchTvPrograms(day: SRGDay) {
+        let applicationConfiguration = ApplicationConfiguration.shared
+        var publishers = [
+            tvProgramsPublisher(day: day, mainProvider: true, minimal: true),
+            tvProgramsPublisher(day: day, mainProvider: true)
+        ]
+        if !applicationConfiguration.tvGuideOtherBouquets.isEmpty {
+            publishers.append(tvProgramsPublisher(day: day, mainProvider: false, minimal: true))
+            publishers.append(tvProgramsPublisher(day: day, mainProvider: false))
+        }
+
+        var cancellable: AnyCancellable?
+        cancellable = Publishers.MergeMany(publishers)
+            .receive(on: DispatchQueue.main)
+            .sink { _ in
+                // Retained until completion
+                cancellable?.cancel()
+                cancellable = nil
+            } receiveValue: { _ in }
+    }
+
+    /// Publishes the TV channels of the main provider, or of the other configured bouquets. Channels last received
+    /// are published first if available.
+    func tvChannelsPublisher(day: SRGDay? = nil, mainProvider: Bool) -> AnyPublisher<[PlayChannel], Error> {
+        let cacheKeys = mainProvider ? [Self.programGuideCacheKey(for: nil)] : ApplicationConfiguration.shared.tvGuideOtherBouquets.map { Self.programGuideCacheKey(for: $0) }
+        let cachedChannelsPublishers = cacheKeys.map { ProgramGuideCache.channels(for: $0) }
+        return Publishers.MergeMany(cachedChannelsPublishers.enumerated().map { index, publisher in publisher.map { (index: index, channels: $0) } })
+            .collect()
+            .map { results -> [PlayChannel]? in
+                let sortedResults = results.sorted { $0.index < $1.index }
+                guard !sortedResults.isEmpty, sortedResults.allSatisfy({ $0.channels != nil }) else { return nil }
+                return sortedResults.flatMap { $0.channels ?? [] }
+            }
+            .setFailureType(to: Error.self)
+            .flatMap { cachedChannels in
+                let channelsPublisher = self.tvProgramsPublisher(day: day, mainProvider: mainProvider, minimal: true)
+                    .map { $0.map(\.channel) }
+                guard let cachedChannels else { return channelsPublisher.eraseToAnyPublisher() }
+                return channelsPublisher
+                    .catch { _ in Empty<[PlayChannel], Error>() }
+                    .prepend(cachedChannels)
+                    .removeDuplicates()
+                    .eraseToAnyPublisher()
+            }
+            .eraseToAnyPublisher()
+    }
+
+    /// Publishes programs from the program guide cache if available, otherwise from the specified request. Days saved
+    /// after they ended never change and are only requested once. Complete programs for other days (including past
+    /// days saved while they were not over yet) are revalidated in the background after the cached ones have been
+    /// published.
+    private func cachedTvProgramsPublisher(
+        for cacheKey: ProgramGuideCache.Key,
+        day: SRGDay?,
+        minimal: Bool,
+        request: @escaping () -> AnyPublisher<[PlayProgramComposition], Error>
+    ) -> AnyPublisher<[PlayProgramComposition], Error> {
+        let day = day ?? SRGDay.today
+        let requestPublisher = Deferred { request() }
+            .handleEvents(receiveOutput: { programCompositions in
+                guard !minimal else { return }
+                ProgramGuideCache.save(programCompositions, for: cacheKey, day: day)
+            })
+
+        return ProgramGuideCache.day(for: cacheKey, day: day)
+            .setFailureType(to: Error.self)
+            .flatMap { cachedDay in
+                guard let cachedDay else { return requestPublisher.eraseToAnyPublisher() }
+
+                // Cached days contain complete programs, which can be used in place of minimal ones
+                let cachedProgramCompositions = cachedDay.programCompositions
+                if minimal || cachedDay.isFinal {
+                    return Just(cachedProgramCompositions)
+                        .setFailureType(to: Error.self)
+                        .eraseToAnyPublisher()
+                } else {
+                    return requestPublisher
+                        .catch { _ in Empty<[PlayProgramComposition], Error>() }
+                        .prepend(cachedProgramCompositions)
+                        .eraseToAnyPublisher()
+                }
+            }
+            .eraseToAnyPublisher()
+    }
+
+    /// The program guide cache key for the main bouquet (`nil`) or another bouquet.
+    private static func programGuideCacheKey(for bouquet: TVGuideBouquet?) -> ProgramGuideCache.Key {
+        let vendor = ApplicationConfiguration.shared.vendor
+        if let bouquet {
+            return ProgramGuideCache.Key(name: "\(vendor.rawValue)-bouquet\(bouquet.rawValue)", external: bouquet == .thirdParty)
+        } else {
+            return ProgramGuideCache.Key(name: "\(vendor.rawValue)-main", external: false)
+        }
+    }
+
+    private static func programsKey(for bouquet: String, day: SRGDay?, minimal: Bool) -> String {
+        let dayKey = day.map { String(Int($0.date.timeIntervalSince1970)) } ?? "today"
+        return "tvPrograms-\(bouquet)-\(dayKey)-\(minimal ? "minimal" : "full")"
+    }
+
     private func tvOtherPartyProgramsPublisher(day: SRGDay? = nil, bouquet: TVGuideBouquet, minimal: Bool = false) -> AnyPublisher<[PlayProgramComposition], Error> {
+        cachedTvProgramsPublisher(for: Self.programGuideCacheKey(for: bouquet), day: day, minimal: minimal) {
+            RequestGateway.shared.publisher(for: Self.programsKey(for: "bouquet\(bouquet.rawValue)", day: day, minimal: minimal), ttl: Self.programsTtl) {
+                Self.tvOtherPartyProgramsRequest(day: day, bouquet: bouquet, minimal: minimal)
+            }
+        }
+    }
+
+    private static func tvOtherPartyProgramsRequest(day: SRGDay?, bouquet: TVGuideBouquet, minimal: Bool) -> AnyPublisher<[PlayProgramComposition], Error> {
         switch bouquet {
         case .RSI:
             SRGDataProvider.current!.tvPrograms(for: .RSI, day: day, minimal: minimal)
@@ -274,6 +474,11 @@ struct PlayProgram: Hashable {
         return DateInterval(start: startDate, end: endDate).contains(date)
     }
 
+    /// The next program start or end date after the specified date, if any
+    func nextBoundary(after date: Date) -> Date? {
+        [wrappedValue.startDate, extendedEndDate].filter { $0 > date }.min()
+    }
+
     func play_accessibilityLabel(with channel: SRGChannel?) -> String {
         let format = PlaySRGAccessibilityLocalizedString("From %1$@ to %2$@", comment: "Text providing program time information. First placeholder is the start time, second is the end time.")
         var label = String(
@@ -304,19 +509,7 @@ enum UserDataPublishers {
     }
 
     static func playbackProgressPublisher(for media: SRGMedia) -> AnyPublisher<Double?, Never> {
-        Publishers.PublishAndRepeat(onOutputFrom: ThrottledSignal.historyUpdates(for: media.urn)) {
-            Deferred {
-                Future<Double?, Never> { promise in
-                    HistoryPlaybackProgressForMediaAsync(media) { progress, completed in
-                        guard completed else { return }
-                        let progressValue = (progress != 0) ? Optional(Double(progress)) : nil
-                        promise(.success(progressValue))
-                    }
-                }
-            }
-        }
-        .prepend(nil)
-        .eraseToAnyPublisher()
+        UserDataCache.shared.playbackProgressPublisher(for: media)
     }
 
     static func favoritePublisher(for show: SRGShow) -> AnyPublisher<Bool, Never> {
@@ -329,17 +522,7 @@ enum UserDataPublishers {
     }
 
     static func laterAllowedActionPublisher(for media: SRGMedia) -> AnyPublisher<WatchLaterAction, Never> {
-        Publishers.PublishAndRepeat(onOutputFrom: ThrottledSignal.watchLaterUpdates(for: media.urn)) {
-            Deferred {
-                Future<WatchLaterAction, Never> { promise in
-                    WatchLaterAllowedActionForMediaAsync(media) { action in
-                        promise(.success(action))
-                    }
-                }
-            }
-        }
-        .prepend(.none)
-        .eraseToAnyPublisher()
+        UserDataCache.shared.laterAllowedActionPublisher(for: media)
     }
 
     #if os(iOS)
@@ -0,0 +1,163 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+import Combine
+
+/**
+ *  Coalesces identical requests made at the same time by several parts of the application (e.g. several scenes or
+ *  pages displayed at once). Requests are identified by a key. A request in flight is shared by all subscribers
+ *  with the same key, and its result is kept for a short time so that idempotent lookups are not repeated.
+ *
+ *  Only suited for requests delivering a single value. Errors are not memoized, and requests finishing without a
+ *  value fail with `RequestGatewayError.noValue`. A request in flight is cancelled when all its subscribers cancel.
+ *
+ *  Can be used from any thread.
+ */
+enum RequestGatewayError: Error {
+    case noValue
+}
+
+final class RequestGateway {
+    static let shared = RequestGateway()
+
+    private final class Entry {
+        let result = CurrentValueSubject<Result<Any, Error>?, Never>(nil)
+        var expirationDate: Date?
+        var cancellable: AnyCancellable?
+        var subscriberCount = 0
+        var isCompleted = false
+    }
+
+    private var entries = [String: Entry]()
+    private let lock = NSLock()
+
+    private var hits = 0
+    private var misses = 0
+    private var joins = 0
+
+    /// The number of requests served from memoized results.
+    var numberOfHits: Int {
+        synchronized { hits }
+    }
+
+    /// The number of requests actually performed.
+    var numberOfMisses: Int {
+        synchronized { misses }
+    }
+
+    /// The number of requests which joined an identical request in flight.
+    var numberOfJoins: Int {
+        synchronized { joins }
+    }
+
+    /**
+     *  Return a publisher delivering the result of the request with the specified key, sharing any identical request
+     *  in flight or a result obtained less than `ttl` seconds ago. The request is created with `makePublisher` if
+     *  needed.
+     */
+    func publisher<T>(for key: String, ttl: TimeInterval, _ makePublisher: @escaping () -> AnyPublisher<T, Error>) -> AnyPublisher<T, Error> {
+        Deferred {
+            let (entry, isNew) = self.entry(for: key)
+            if isNew {
+                entry.cancellable = makePublisher()
+                    .first()
+                    .sink { [weak self] completion in
+                        switch completion {
+                        case let .failure(error):
+                            self?.complete(entry, for: key, with: .failure(error), ttl: ttl)
+                        case .finished:
+                            // No effect if a value was received
+                            self?.complete(entry, for: key, with: .failure(RequestGatewayError.noValue), ttl: ttl)
+                        }
+                    } receiveValue: { [weak self] value in
+                        self?.complete(entry, for: key, with: .success(value), ttl: ttl)
+                    }
+            }
+            return entry.result
+                .compactMap { $0 }
+                .first()
+                .tryMap { result in
+                    // swiftlint:disable:next force_cast
+                    try result.get() as! T
+                }
+                .handleEvents(receiveCancel: { [weak self] in
+                    self?.cancel(entry, for: key)
+                })
+        }
+        .eraseToAnyPublisher()
+    }
+
+    private func synchronized<T>(_ block: () -> T) -> T {
+        lock.lock()
+        defer { lock.unlock() }
+        return block()
+    }
+
+    private func entry(for key: String) -> (entry: Entry, isNew: Bool) {
+        synchronized {
+            if let entry = entries[key] {
+                if let expirationDate = entry.expirationDate {
+                    if expirationDate > Date() {
+                        hits += 1
+                        entry.subscriberCount += 1
+                        return (entry, false)
+                    }
+                } else {
+                    joins += 1
+                    entry.subscriberCount += 1
+                    return (entry, false)
+                }
+            }
+
+            misses += 1
+            let entry = Entry()
+            entry.subscriberCount = 1
+            entries[key] = entry
+            return (entry, true)
+        }
+    }
+
+    private func cancel(_ entry: Entry, for key: String) {
+        let cancellable: AnyCancellable? = synchronized {
+            entry.subscriberCount -= 1
+            guard entry.subscriberCount == 0, !entry.isCompleted else { return nil }
+
+            // Abandoned request
+            if entries[key] === entry {
+                entries[key] = nil
+            }
+            let cancellable = entry.cancellable
+            entry.cancellable = nil
+            return cancellable
+        }
+        cancellable?.cancel()
+    }
+
+    private func complete(_ entry: Entry, for key: String, with result: Result<Any, Error>, ttl: TimeInterval) {
+        let wasCompleted = synchronized {
+            guard !entry.isCompleted else { return true }
+            entry.isCompleted = true
+
+            if case .success = result {
+                entry.expirationDate = Date().addingTimeInterval(ttl)
+            } else if entries[key] === entry {
+                entries[key] = nil
+            }
+
+            // Discard expired results
+            let date = Date()
+            entries = entries.filter { _, entry in
+                guard let expirationDate = entry.expirationDate else { return true }
+                return expirationDate > date
+            }
+            return false
+        }
+        guard !wasCompleted else { return }
+
+        // Deliver outside the lock so that subscribers can safely issue new requests
+        entry.result.send(result)
+    }
+}
@@ -296,8 +296,8 @@ final class SectionViewController: UIViewController {
         contentInsets = Self.contentInsets(for: state)
         play_setNeedsContentInsetsUpdate()
 
-        DispatchQueue.global(qos: .userInteractive).async {
-            // Can be triggered on a background thread. Layout is updated on the main thread.
+        Content.snapshotQueue.async {
+            // Can be triggered on a background thread (always the same one). Layout is updated on the main thread.
             self.dataSource.apply(Self.snapshot(from: state)) {
                 #if os(iOS)
                     self.collectionView.reloadSectionIndexBar()
@@ -36,25 +36,19 @@ final class SectionViewModel: ObservableObject {
         // Use property capture list (simpler code than if `self` is weakly captured). Only safe because we are
         // capturing constant values (see https://www.swiftbysundell.com/articles/swifts-closure-capturing-mechanics/)
         Publishers.Publish(onOutputFrom: reloadSignal()) { [configuration, trigger] in
-            return Publishers.CombineLatest(
-                configuration.properties.publisher(pageSize: ApplicationConfiguration.shared.detailPageSize,
-                                                   paginatedBy: trigger.signal(activatedBy: TriggerId.loadMore),
-                                                   filter: filter)
-                    .scan([]) { $0 + $1 },
-                configuration.properties.interactiveUpdatesPublisher()
-                    .prepend(Just([]))
-                    .setFailureType(to: Error.self)
-            )
-            .map { items, removedItems in
-                items.filter { !removedItems.contains($0) }
-            }
-            .map { items in
-                let rows = configuration.viewModelProperties.rows(from: removeDuplicates(in: items))
-                return State.loaded(rows: rows)
-            }
-            .catch { error in
-                Just(State.failed(error: error))
-            }
+            configuration.properties.publisher(pageSize: ApplicationConfiguration.shared.detailPageSize,
+                                               paginatedBy: trigger.signal(activatedBy: TriggerId.loadMore),
+                                               filter: filter)
+                .receive(on: Content.processingQueue)
+                .accumulateItems(applying: configuration.properties.interactiveUpdatesPublisher(),
+                                 replacingPages: configuration.properties.publishesContentUpdates)
+                .map { items in
+                    let rows = configuration.viewModelProperties.rows(from: items)
+                    return State.loaded(rows: rows)
+                }
+                .catch { error in
+                    Just(State.failed(error: error))
+                }
         }
         .receive(on: DispatchQueue.main)
         .assign(to: &$state)
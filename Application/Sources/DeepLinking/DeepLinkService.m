@@ -25,6 +25,13 @@ NSString * const DeepLinkDiagnosticsServiceName = @"DeepLinkDiagnosticsServiceNa
 @property (nonatomic) NSURL *serviceURL;
 @property (nonatomic, weak) SRGRequest *request;
 
+// Parsing engine, lazily loaded once and reused until a new script version is downloaded
+@property (nonatomic) JSContext *context;
+@property (nonatomic) JSValue *parseFunction;
+
+// Recent conversion results (`NSURL` or `NSNull`), keyed by web URL string
+@property (nonatomic) NSCache<NSString *, id> *customURLs;
+
 @end
 
 @implementation DeepLinkService
@@ -48,6 +55,9 @@ NSString * const DeepLinkDiagnosticsServiceName = @"DeepLinkDiagnosticsServiceNa
     if (self = [super init]) {
         self.serviceURL = serviceURL;
         
+        self.customURLs = [[NSCache alloc] init];
+        self.customURLs.countLimit = 100;
+        
         [NSNotificationCenter.defaultCenter addObserver:self
                                                selector:@selector(reachabilityDidChange:)
                                                    name:FXReachabilityStatusDidChangeNotification
@@ -79,14 +89,35 @@ NSString * const DeepLinkDiagnosticsServiceName = @"DeepLinkDiagnosticsServiceNa
 #pragma mark Getters and setters
 
 - (NSURL *)customURLFromWebURL:(NSURL *)URL
+{
+    @synchronized (self) {
+        NSString *key = URL.absoluteString;
+        id customURL = [self.customURLs objectForKey:key];
+        if (! customURL) {
+            customURL = [self parseCustomURLFromWebURL:URL] ?: NSNull.null;
+            [self.customURLs setObject:customURL forKey:key];
+        }
+        
+        if (! [customURL isKindOfClass:NSURL.class]) {
+            return nil;
+        }
+        
+        // Unsupported URLs are cached as well, but reported each time they are opened
+        if ([[customURL host].lowercaseString isEqualToString:@"unsupported"]) {
+            [self reportUnsupportedWebURL:URL];
+            return nil;
+        }
+        
+        return customURL;
+    }
+}
+
+- (NSURL *)parseCustomURLFromWebURL:(NSURL *)URL
 {
     NSURLComponents *URLComponents = [NSURLComponents componentsWithURL:URL resolvingAgainstBaseURL:NO];
     
-    NSString *javaScriptFilePath = [self parsePlayURLFilePath];
-    NSString *javaScript = [NSString stringWithContentsOfFile:javaScriptFilePath encoding:NSUTF8StringEncoding error:NULL];
-    JSContext *context = [[JSContext alloc] init];
-    [context evaluateScript:javaScript];
-    JSValue *evaluate = [context objectForKeyedSubscript:@"parseForPlayApp"];
+    [self loadParseFunctionIfNeeded];
+    JSValue *evaluate = self.parseFunction;
     
     NSMutableDictionary *queryItems = [NSMutableDictionary dictionary];
     [URLComponents.queryItems enumerateObjectsUsingBlock:^(NSURLQueryItem * _Nonnull queryItem, NSUInteger idx, BOOL * _Nonnull stop) {
@@ -105,23 +136,41 @@ NSString * const DeepLinkDiagnosticsServiceName = @"DeepLinkDiagnosticsServiceNa
         return nil;
     }
     
-    NSURL *playURL = [NSURL URLWithString:resultString];
-    if (! playURL) {
-        return nil;
+    return [NSURL URLWithString:resultString];
+}
+
+- (void)reportUnsupportedWebURL:(NSURL *)URL
+{
+    SRGDiagnosticReport *report = [[SRGDiagnosticsService serviceWithName:DeepLinkDiagnosticsServiceName] reportWithName:URL.absoluteString];
+    [report setString:[[NSDateFormatter play_rfc3339Date] stringFromDate:NSDate.date] forKey:@"clientTime"];
+    [report setString:NSBundle.mainBundle.bundleIdentifier forKey:@"clientId"];
+    [report setNumber:[self.context objectForKeyedSubscript:@"parsePlayUrlVersion"].toNumber forKey:@"jsVersion"];
+    [report setString:URL.absoluteString forKey:@"url"];
+    [report finish];
+}
+
+- (void)loadParseFunctionIfNeeded
+{
+    if (self.parseFunction) {
+        return;
     }
     
-    if ([playURL.host.lowercaseString isEqualToString:@"unsupported"]) {
-        SRGDiagnosticReport *report = [[SRGDiagnosticsService serviceWithName:DeepLinkDiagnosticsServiceName] reportWithName:URL.absoluteString];
-        [report setString:[[NSDateFormatter play_rfc3339Date] stringFromDate:NSDate.date] forKey:@"clientTime"];
-        [report setString:NSBundle.mainBundle.bundleIdentifier forKey:@"clientId"];
-        [report setNumber:[context objectForKeyedSubscript:@"parsePlayUrlVersion"].toNumber forKey:@"jsVersion"];
-        [report setString:URL.absoluteString forKey:@"url"];
-        [report finish];
-        
-        return nil;
-    }
+    NSString *javaScriptFilePath = [self parsePlayURLFilePath];
+    NSString *javaScript = [NSString stringWithContentsOfFile:javaScriptFilePath encoding:NSUTF8StringEncoding error:NULL];
+    JSContext *context = [[JSContext alloc] init];
+    [context evaluateScript:javaScript];
     
-    return playURL;
+    self.context = context;
+    self.parseFunction = [context objectForKeyedSubscript:@"parseForPlayApp"];
+}
+
+- (void)reloadParseFunction
+{
+    @synchronized (self) {
+        self.context = nil;
+        self.parseFunction = nil;
+        [self.customURLs removeAllObjects];
+    }
 }
 
 - (NSString *)parsePlayURLFilePath
@@ -148,11 +197,20 @@ NSString * const DeepLinkDiagnosticsServiceName = @"DeepLinkDiagnosticsServiceNa
         NSURL *URL = [NSURL URLWithString:@"api/v2/deeplink/parsePlayUrl.js" relativeToURL:self.serviceURL];
         SRGRequest *request = [SRGRequest dataRequestWithURLRequest:[NSURLRequest requestWithURL:URL] session:NSURLSession.sharedSession completionBlock:^(NSData * _Nullable data, NSURLResponse * _Nullable response, NSError * _Nullable error) {
             if (data) {
+                // Only hot-swap the parsing engine if the script changed
+                NSData *existingData = [NSData dataWithContentsOfFile:[self libraryParsePlayURLFilePath]];
+                if ([data isEqualToData:existingData]) {
+                    return;
+                }
+                
                 NSError *writeError = nil;
                 [data writeToFile:[self libraryParsePlayURLFilePath] options:NSDataWritingAtomic error:&writeError];
                 if (writeError) {
                     PlayLogError(@"DeepLink", @"Could not save deep linking parsing JavaScript file. Reason: %@", writeError);
                 }
+                else {
+                    [self reloadParseFunction];
+                }
             }
         }];
         [request resume];
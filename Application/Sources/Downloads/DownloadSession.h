@@ -44,13 +44,64 @@ typedef NS_ENUM(NSInteger, DownloadSessionState) {
 
 @property (nonatomic, readonly) DownloadSessionState state;
 
+/**
+ *  Maximum number of files transferred at the same time. Other files are queued and transferred by priority: media
+ *  files of downloads added by the user first, then media files of restored downloads, and images last. Default is 2.
+ *
+ *  @discussion Queued files are only handed to the background session when a slot is available. When the application
+ *              is in the background, this happens when the system wakes it because a transfer finished (see
+ *              `-handleEventsForBackgroundURLSessionWithIdentifier:completionHandler:`). Transfers started in the
+ *              background might be deferred by the system, and the queue is stalled if the application was killed by
+ *              the user, until it is opened again. This is the price of limiting concurrency and cellular usage, which
+ *              the background session itself cannot do per network type.
+ */
+@property (nonatomic) NSUInteger maximumConcurrentTaskCount;
+
+/**
+ *  Maximum number of files transferred at the same time over cellular networks, limiting the bandwidth used by
+ *  downloads. Transfers exceeding the limit when switching to a cellular network are paused and resumed later. Set
+ *  to 0 to apply `maximumConcurrentTaskCount` to all networks. Default is 1.
+ */
+@property (nonatomic) NSUInteger maximumConcurrentTaskCountOverCellular;
+
+/**
+ *  Add a download initiated by the user.
+ */
 - (BOOL)addDownload:(Download *)download;
+
+/**
+ *  Add a download, with lower priority if not initiated by the user (e.g. when restoring downloads at startup).
+ *  Return `NO` if the download was already added or has no file to transfer.
+ */
+- (BOOL)addDownload:(Download *)download userInitiated:(BOOL)userInitiated;
+
+/**
+ *  Add downloads restored at startup, with the priority of downloads not initiated by the user. Tasks still running
+ *  since a previous application session are only matched with downloads, and files only transferred, once this method
+ *  has been called. Subsequent calls are ignored.
+ */
+- (void)restoreDownloads:(NSArray<Download *> *)downloads;
+
 - (void)removeDownload:(Download *)download;
 - (BOOL)hasTasksForDownload:(Download *)download;
 - (BOOL)isDownloadingDownload:(Download *)download;
 
 - (nullable NSProgress *)currentlyKnownProgressForDownload:(Download *)download;
 
+/**
+ *  Must be called when the system wakes the application for events of a background session, so that queued files
+ *  can be started. The completion handler is called once all events of the download session have been processed.
+ *  Identifiers of other sessions are ignored.
+ */
+- (void)handleEventsForBackgroundURLSessionWithIdentifier:(NSString *)identifier completionHandler:(void (^)(void))completionHandler;
+
+/**
+ *  Remove saved resume data of transfers which do not belong to the downloads with the specified URNs.
+ *
+ *  @discussion Can be called on any thread.
+ */
+- (void)removeResumeDataExceptForDownloadURNs:(NSSet<NSString *> *)URNs;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -10,7 +10,6 @@
 #import "PlayLogger.h"
 #import "Reachability.h"
 
-@import libextobjc;
 @import SRGLogger;
 
 NSString * const DownloadSessionStateDidChangeNotification = @"DownloadSessionStateDidChangeNotification";
@@ -19,15 +18,54 @@ NSString * const DownloadSessionStateKey = @"DownloadSessionState";
 NSString * const DownloadProgressDidChangeNotification = @"DownloadProgressDidChangeNotification";
 NSString * const DownloadProgressKey = @"DownloadProgress";
 
+static NSString * const DownloadSessionIdentifier = @"ch.srgssr.play.downloads";
+
+/**
+ *  Transfer priorities, from highest to lowest.
+ */
+typedef NS_ENUM(NSInteger, DownloadSessionJobPriority) {
+    DownloadSessionJobPriorityUserInitiated,
+    DownloadSessionJobPriorityDefault,
+    DownloadSessionJobPriorityArtwork
+};
+
+/**
+ *  Transfer of a download file (media or image). Jobs are pending until a task is started for them.
+ */
+@interface DownloadSessionJob : NSObject
+
+- (instancetype)initWithDownload:(Download *)download media:(BOOL)media priority:(DownloadSessionJobPriority)priority sequenceNumber:(NSUInteger)sequenceNumber;
+
+@property (nonatomic, readonly) Download *download;
+@property (nonatomic, readonly, getter=isMedia) BOOL media;
+@property (nonatomic, readonly) DownloadSessionJobPriority priority;
+@property (nonatomic, readonly) NSUInteger sequenceNumber;
+
+@property (nonatomic, readonly, nullable) NSURL *URL;
+
+@property (nonatomic, nullable) NSURLSessionDownloadTask *task;
+@property (nonatomic, nullable) NSProgress *progress;                  // Main thread only
+
+- (NSComparisonResult)compare:(DownloadSessionJob *)job;
+
+@end
+
 @interface DownloadSession ()
 
 @property (nonatomic) NSURLSession *session;
 
-@property (nonatomic) NSMutableDictionary<NSNumber *, Download *> *downloads;
-@property (nonatomic) NSMutableDictionary<NSNumber *, NSProgress *> *progresses;
+// Jobs are only accessed when synchronized on the session
+@property (nonatomic) NSMutableDictionary<NSString *, NSMutableArray<DownloadSessionJob *> *> *jobsByURN;
+@property (nonatomic) NSMutableDictionary<NSNumber *, DownloadSessionJob *> *runningJobs;
+@property (nonatomic) NSMutableArray<DownloadSessionJob *> *pendingJobs;                        // Sorted by priority
+@property (nonatomic) NSUInteger jobSequenceNumber;
+@property (nonatomic, getter=areTasksSynchronized) BOOL tasksSynchronized;
+@property (nonatomic, getter=areDownloadsRestored) BOOL downloadsRestored;
 
 @property (nonatomic) DownloadSessionState state;
 
+@property (nonatomic, copy, nullable) void (^backgroundEventsCompletionHandler)(void);
+
 @end
 
 @implementation DownloadSession
@@ -46,18 +84,47 @@ NSString * const DownloadProgressKey = @"DownloadProgress";
     return s_downloadSession;
 }
 
++ (NSString *)resumeDataDirectoryPath
+{
+    static NSString *s_resumeDataDirectoryPath;
+    static dispatch_once_t s_onceToken;
+    dispatch_once(&s_onceToken, ^{
+        NSString *cachesDirectoryPath = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+        s_resumeDataDirectoryPath = [cachesDirectoryPath stringByAppendingPathComponent:@"DownloadResumeData"];
+        NSError *error = nil;
+        [NSFileManager.defaultManager createDirectoryAtPath:s_resumeDataDirectoryPath
+                                withIntermediateDirectories:YES
+                                                 attributes:nil
+                                                      error:&error];
+        if (error) {
+            PlayLogError(@"download", @"Could not create the resume data directory. Reason: %@", error);
+        }
+    });
+    return s_resumeDataDirectoryPath;
+}
+
++ (NSString *)resumeDataFilePathForDownload:(Download *)download
+{
+    NSString *fileName = [download.URN stringByAddingPercentEncodingWithAllowedCharacters:NSCharacterSet.alphanumericCharacterSet] ?: download.URN;
+    return [[self resumeDataDirectoryPath] stringByAppendingPathComponent:fileName];
+}
+
 #pragma mark Object lifecycle
 
 - (instancetype)init
 {
     if (self = [super init]) {
-        NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration backgroundSessionConfigurationWithIdentifier:@"ch.srgssr.play.downloads"];
+        NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration backgroundSessionConfigurationWithIdentifier:DownloadSessionIdentifier];
         configuration.allowsCellularAccess = YES;
         configuration.discretionary = NO;
         self.session = [NSURLSession sessionWithConfiguration:configuration delegate:self delegateQueue:nil];
         
-        self.downloads = [NSMutableDictionary new];
-        self.progresses = [NSMutableDictionary new];
+        self.jobsByURN = [NSMutableDictionary new];
+        self.runningJobs = [NSMutableDictionary new];
+        self.pendingJobs = [NSMutableArray new];
+        
+        _maximumConcurrentTaskCount = 2;
+        _maximumConcurrentTaskCountOverCellular = 1;
         
         self.state = DownloadSessionStateIdle;
         
@@ -84,10 +151,40 @@ NSString * const DownloadProgressKey = @"DownloadProgress";
                                                     userInfo:@{DownloadSessionStateKey : @(state)}];
 }
 
+- (void)setMaximumConcurrentTaskCount:(NSUInteger)maximumConcurrentTaskCount
+{
+    @synchronized (self) {
+        _maximumConcurrentTaskCount = maximumConcurrentTaskCount;
+        [self startPendingJobs];
+    }
+}
+
+- (void)setMaximumConcurrentTaskCountOverCellular:(NSUInteger)maximumConcurrentTaskCountOverCellular
+{
+    @synchronized (self) {
+        _maximumConcurrentTaskCountOverCellular = maximumConcurrentTaskCountOverCellular;
+        [self startPendingJobs];
+    }
+}
+
+- (NSUInteger)currentMaximumConcurrentTaskCount
+{
+    NSUInteger maximumConcurrentTaskCount = self.maximumConcurrentTaskCount;
+    if (self.maximumConcurrentTaskCountOverCellular != 0 && [FXReachability sharedInstance].status == FXReachabilityStatusReachableViaWWAN) {
+        maximumConcurrentTaskCount = MIN(maximumConcurrentTaskCount, self.maximumConcurrentTaskCountOverCellular);
+    }
+    return MAX(maximumConcurrentTaskCount, 1);
+}
+
 - (void)setNeedsStateUpdate
 {
     dispatch_async(dispatch_get_main_queue(), ^{
-        if (self.downloads.count != 0) {
+        BOOL hasJobs = NO;
+        @synchronized (self) {
+            hasJobs = (self.jobsByURN.count != 0);
+        }
+        
+        if (hasJobs) {
             self.state = [FXReachability isReachable] ? DownloadSessionStateDownloading : DownloadSessionStateDownloadingSuspended;
         }
         else {
@@ -100,100 +197,351 @@ NSString * const DownloadProgressKey = @"DownloadProgress";
 
 - (BOOL)addDownload:(Download *)download
 {
-    NSString *keyPath = [NSString stringWithFormat:@"@distinctUnionOfObjects.%@", @keypath(Download.new, URN)];
-    if ([[self.downloads.allValues valueForKeyPath:keyPath] containsObject:download.URN]) {
+    return [self addDownload:download userInitiated:YES];
+}
+
+- (BOOL)addDownload:(Download *)download userInitiated:(BOOL)userInitiated
+{
+    BOOL added = NO;
+    
+    @synchronized (self) {
+        added = [self registerDownload:download userInitiated:userInitiated];
+        if (added) {
+            [self startPendingJobs];
+        }
+    }
+    
+    [self setNeedsStateUpdate];
+    
+    return added;
+}
+
+- (void)restoreDownloads:(NSArray<Download *> *)downloads
+{
+    @synchronized (self) {
+        if (self.downloadsRestored) {
+            return;
+        }
+        
+        for (Download *download in downloads) {
+            [self registerDownload:download userInitiated:NO];
+        }
+        self.downloadsRestored = YES;
+    }
+    
+    // Tasks are only started once tasks from a previous application session have been matched with restored downloads
+    [self synchronizeTasks];
+}
+
+- (void)removeDownload:(Download *)download
+{
+    NSMutableArray<NSURLSessionDownloadTask *> *tasks = [NSMutableArray array];
+    
+    @synchronized (self) {
+        NSArray<DownloadSessionJob *> *jobs = self.jobsByURN[download.URN].copy;
+        for (DownloadSessionJob *job in jobs) {
+            if (job.task) {
+                [tasks addObject:job.task];
+            }
+            [self removeJob:job];
+        }
+        [self startPendingJobs];
+    }
+    
+    [tasks makeObjectsPerformSelector:@selector(cancel)];
+    [self removeResumeDataForDownload:download];
+    
+    [self setNeedsStateUpdate];
+}
+
+- (BOOL)hasTasksForDownload:(Download *)download
+{
+    @synchronized (self) {
+        return self.jobsByURN[download.URN] != nil;
+    }
+}
+
+- (BOOL)isDownloadingDownload:(Download *)download {
+    return [self hasTasksForDownload:download] && [FXReachability isReachable];
+}
+
+- (nullable NSProgress *)currentlyKnownProgressForDownload:(Download *)download {
+    @synchronized (self) {
+        return [self mediaJobForURN:download.URN].progress;
+    }
+}
+
+- (void)handleEventsForBackgroundURLSessionWithIdentifier:(NSString *)identifier completionHandler:(void (^)(void))completionHandler
+{
+    if (! [identifier isEqualToString:DownloadSessionIdentifier]) {
+        return;
+    }
+    
+    // Delegate events are delivered once the session has been created, which creating the shared instance ensures.
+    // Downloads must be restored as well, so that tasks are synchronized and queued files can be started.
+    self.backgroundEventsCompletionHandler = completionHandler;
+    [Download class];
+}
+
+#pragma mark Scheduling (synchronized on the session)
+
+// Register jobs for the files of a download which are missing. Return `NO` if the download was already registered
+// or has no file to transfer.
+- (BOOL)registerDownload:(Download *)download userInitiated:(BOOL)userInitiated
+{
+    if (self.jobsByURN[download.URN]) {
         return NO;
     }
     
-    BOOL added = NO;
+    NSMutableArray<DownloadSessionJob *> *jobs = [NSMutableArray array];
     
     if (! download.localImageFileURL) {
-        NSURLSessionDownloadTask *imageFileTask = [self.session downloadTaskWithURL:download.downloadImageURL];
-        self.downloads[@(imageFileTask.taskIdentifier)] = download;
-        [imageFileTask resume];
-        added = YES;
+        [jobs addObject:[[DownloadSessionJob alloc] initWithDownload:download
+                                                               media:NO
+                                                            priority:DownloadSessionJobPriorityArtwork
+                                                      sequenceNumber:self.jobSequenceNumber++]];
     }
     
     if (! download.localMediaFileURL) {
-        NSURLSessionDownloadTask *mediaFileTask = [self.session downloadTaskWithURL:download.downloadMediaURL];
-        self.downloads[@(mediaFileTask.taskIdentifier)] = download;
-        [mediaFileTask resume];
-        added = YES;
+        [jobs addObject:[[DownloadSessionJob alloc] initWithDownload:download
+                                                               media:YES
+                                                            priority:userInitiated ? DownloadSessionJobPriorityUserInitiated : DownloadSessionJobPriorityDefault
+                                                      sequenceNumber:self.jobSequenceNumber++]];
     }
     
-    [self setNeedsStateUpdate];
+    if (jobs.count == 0) {
+        return NO;
+    }
     
-    return added;
+    self.jobsByURN[download.URN] = jobs;
+    for (DownloadSessionJob *job in jobs) {
+        [self enqueueJob:job];
+    }
+    return YES;
 }
 
-- (void)restoreSessionState
+- (DownloadSessionJob *)mediaJobForURN:(NSString *)URN
 {
-    [self.session getTasksWithCompletionHandler:^(NSArray<NSURLSessionDataTask *> * _Nonnull dataTasks, NSArray<NSURLSessionUploadTask *> * _Nonnull uploadTasks, NSArray<NSURLSessionDownloadTask *> * _Nonnull downloadTasks) {
-        NSMutableDictionary *copyDownloads = self.downloads.mutableCopy;
-        // Enumerate all download tasks
-        [downloadTasks enumerateObjectsUsingBlock:^(NSURLSessionDownloadTask * _Nonnull downloadTask, NSUInteger idx, BOOL * _Nonnull stop) {
-            // Resume found task
-            if (copyDownloads[@(downloadTask.taskIdentifier)]) {
-                copyDownloads[@(downloadTask.taskIdentifier)] = nil;
-                [downloadTask resume];
+    if (! URN) {
+        return nil;
+    }
+    
+    for (DownloadSessionJob *job in self.jobsByURN[URN]) {
+        if (job.media) {
+            return job;
+        }
+    }
+    return nil;
+}
+
+- (void)enqueueJob:(DownloadSessionJob *)job
+{
+    NSUInteger index = [self.pendingJobs indexOfObject:job
+                                         inSortedRange:NSMakeRange(0, self.pendingJobs.count)
+                                               options:NSBinarySearchingInsertionIndex | NSBinarySearchingLastEqual
+                                       usingComparator:^NSComparisonResult(DownloadSessionJob * _Nonnull job1, DownloadSessionJob * _Nonnull job2) {
+        return [job1 compare:job2];
+    }];
+    [self.pendingJobs insertObject:job atIndex:index];
+}
+
+- (void)attachTask:(NSURLSessionDownloadTask *)task toJob:(DownloadSessionJob *)job
+{
+    job.task = task;
+    self.runningJobs[@(task.taskIdentifier)] = job;
+}
+
+- (void)detachTaskFromJob:(DownloadSessionJob *)job
+{
+    if (job.task) {
+        self.runningJobs[@(job.task.taskIdentifier)] = nil;
+        job.task = nil;
+    }
+}
+
+- (void)removeJob:(DownloadSessionJob *)job
+{
+    [self detachTaskFromJob:job];
+    [self.pendingJobs removeObject:job];
+    
+    NSString *URN = job.download.URN;
+    NSMutableArray<DownloadSessionJob *> *jobs = self.jobsByURN[URN];
+    [jobs removeObject:job];
+    if (jobs.count == 0) {
+        self.jobsByURN[URN] = nil;
+    }
+}
+
+- (BOOL)isRegisteredJob:(DownloadSessionJob *)job
+{
+    return [self.jobsByURN[job.download.URN] containsObject:job];
+}
+
+- (void)startJob:(DownloadSessionJob *)job
+{
+    NSData *resumeData = job.media ? [self resumeDataForDownload:job.download] : nil;
+    NSURLSessionDownloadTask *task = nil;
+    if (resumeData) {
+        task = [self.session downloadTaskWithResumeData:resumeData];
+        [self removeResumeDataForDownload:job.download];
+    }
+    else {
+        task = [self.session downloadTaskWithURL:job.URL];
+    }
+    
+    // The URN is stored with the task so that tasks can be matched with downloads in later application sessions
+    task.taskDescription = job.download.URN;
+    [self attachTask:task toJob:job];
+    [task resume];
+}
+
+- (void)pauseJob:(DownloadSessionJob *)job
+{
+    NSURLSessionDownloadTask *task = job.task;
+    [self detachTaskFromJob:job];
+    
+    // The job is queued again once resume data has been received, so that the transfer can continue where it stopped
+    [task cancelByProducingResumeData:^(NSData * _Nullable resumeData) {
+        @synchronized (self) {
+            if (! [self isRegisteredJob:job]) {
+                return;
             }
-            // Cancel non registered task
-            else {
-                [downloadTask cancel];
+            
+            if (resumeData && job.media) {
+                [self saveResumeData:resumeData forDownload:job.download];
             }
-        }];
-        
-        // Get missing Downloads
-        NSSet<Download *> *missingDownloads = [NSSet setWithArray:copyDownloads.allValues];
+            [self enqueueJob:job];
+            [self startPendingJobs];
+        }
+    }];
+}
+
+- (void)startPendingJobs
+{
+    if (! self.tasksSynchronized) {
+        return;
+    }
+    
+    NSUInteger maximumConcurrentTaskCount = [self currentMaximumConcurrentTaskCount];
+    while (self.runningJobs.count < maximumConcurrentTaskCount && self.pendingJobs.count != 0) {
+        DownloadSessionJob *job = self.pendingJobs.firstObject;
+        [self.pendingJobs removeObjectAtIndex:0];
+        [self startJob:job];
+    }
+    
+    // Pause lowest priority transfers if the limit was lowered, e.g. when switching to a cellular network
+    if (self.runningJobs.count > maximumConcurrentTaskCount) {
+        NSArray<DownloadSessionJob *> *runningJobs = [self.runningJobs.allValues sortedArrayUsingSelector:@selector(compare:)];
+        NSArray<DownloadSessionJob *> *pausedJobs = [runningJobs subarrayWithRange:NSMakeRange(maximumConcurrentTaskCount, runningJobs.count - maximumConcurrentTaskCount)];
+        for (DownloadSessionJob *job in pausedJobs) {
+            [self pauseJob:job];
+        }
+    }
+}
+
+- (void)synchronizeTasks
+{
+    @synchronized (self) {
+        // Avoid starting tasks which would be missing from the list
+        self.tasksSynchronized = NO;
+    }
+    
+    [self.session getTasksWithCompletionHandler:^(NSArray<NSURLSessionDataTask *> * _Nonnull dataTasks, NSArray<NSURLSessionUploadTask *> * _Nonnull uploadTasks, NSArray<NSURLSessionDownloadTask *> * _Nonnull downloadTasks) {
+        NSMutableArray<NSURLSessionDownloadTask *> *cancelledTasks = [NSMutableArray array];
         
-        // Clean registered tasks
-        [copyDownloads enumerateKeysAndObjectsUsingBlock:^(id _Nonnull key, id _Nonnull obj, BOOL * _Nonnull stop) {
-            self.downloads[key] = nil;
-            self.progresses[key] = nil;
-        }];
+        @synchronized (self) {
+            NSMutableSet<NSNumber *> *taskIdentifiers = [NSMutableSet set];
+            
+            for (NSURLSessionDownloadTask *downloadTask in downloadTasks) {
+                NSNumber *key = @(downloadTask.taskIdentifier);
+                
+                // Resume found task
+                if (self.runningJobs[key]) {
+                    [taskIdentifiers addObject:key];
+                    [downloadTask resume];
+                    continue;
+                }
+                
+                // Adopt tasks still transferring files for a download since a previous application session
+                DownloadSessionJob *job = nil;
+                for (DownloadSessionJob *pendingJob in self.jobsByURN[downloadTask.taskDescription]) {
+                    if (! pendingJob.task && [pendingJob.URL isEqual:downloadTask.originalRequest.URL] && [self.pendingJobs containsObject:pendingJob]) {
+                        job = pendingJob;
+                        break;
+                    }
+                }
+                
+                if (job) {
+                    [self.pendingJobs removeObject:job];
+                    [self attachTask:downloadTask toJob:job];
+                    [taskIdentifiers addObject:key];
+                    [downloadTask resume];
+                }
+                // Cancel non registered task
+                else {
+                    [cancelledTasks addObject:downloadTask];
+                }
+            }
+            
+            // Queue jobs whose task is missing again
+            for (NSNumber *key in self.runningJobs.allKeys) {
+                if (! [taskIdentifiers containsObject:key]) {
+                    DownloadSessionJob *job = self.runningJobs[key];
+                    [self detachTaskFromJob:job];
+                    [self enqueueJob:job];
+                }
+            }
+            
+            self.tasksSynchronized = YES;
+            [self startPendingJobs];
+        }
         
-        [missingDownloads enumerateObjectsUsingBlock:^(Download * _Nonnull download, BOOL * _Nonnull stop) {
-            [self addDownload:download];
-        }];
+        [cancelledTasks makeObjectsPerformSelector:@selector(cancel)];
         
         [self setNeedsStateUpdate];
     }];
 }
 
-- (void)removeDownload:(Download *)download
+#pragma mark Resume data
+
+- (NSData *)resumeDataForDownload:(Download *)download
 {
-    NSArray *keys = [self.downloads.copy allKeysForObject:download];
-    if (keys.count != 0) {
-        [self.session getTasksWithCompletionHandler:^(NSArray<NSURLSessionDataTask *> * _Nonnull dataTasks, NSArray<NSURLSessionUploadTask *> * _Nonnull uploadTasks, NSArray<NSURLSessionDownloadTask *> * _Nonnull downloadTasks) {
-            [downloadTasks enumerateObjectsUsingBlock:^(NSURLSessionDownloadTask * _Nonnull task, NSUInteger idx, BOOL * _Nonnull stop) {
-                if ([keys containsObject:@(task.taskIdentifier)]) {
-                    self.downloads[@(task.taskIdentifier)] = nil;
-                    [task cancel];
-                };
-            }];
-            
-            [self setNeedsStateUpdate];
-        }];
-    }
+    return [NSData dataWithContentsOfFile:[DownloadSession resumeDataFilePathForDownload:download]];
 }
 
-- (BOOL)hasTasksForDownload:(Download *)download
+- (void)saveResumeData:(NSData *)resumeData forDownload:(Download *)download
 {
-    return [self.downloads allKeysForObject:download].count != 0;
+    NSError *error = nil;
+    if (! [resumeData writeToFile:[DownloadSession resumeDataFilePathForDownload:download] options:NSDataWritingAtomic error:&error]) {
+        PlayLogError(@"download", @"Could not save resume data for %@. Reason: %@", download.URN, error);
+    }
 }
 
-- (BOOL)isDownloadingDownload:(Download *)download {
-    return [self hasTasksForDownload:download] && [FXReachability isReachable];
+- (void)removeResumeDataExceptForDownloadURNs:(NSSet<NSString *> *)URNs
+{
+    NSString *directoryPath = [DownloadSession resumeDataDirectoryPath];
+    for (NSString *fileName in [NSFileManager.defaultManager contentsOfDirectoryAtPath:directoryPath error:NULL]) {
+        NSString *URN = fileName.stringByRemovingPercentEncoding ?: fileName;
+        if ([URNs containsObject:URN]) {
+            continue;
+        }
+        
+        @synchronized (self) {
+            if (self.jobsByURN[URN]) {
+                continue;
+            }
+        }
+        
+        [NSFileManager.defaultManager removeItemAtPath:[directoryPath stringByAppendingPathComponent:fileName] error:NULL];
+    }
 }
 
-- (nullable NSProgress *)currentlyKnownProgressForDownload:(Download *)download {
-    NSArray<NSNumber *> *keys = [self.downloads allKeysForObject:download];
-    for (NSNumber *key in keys) {
-        if (self.progresses[key]) {
-            return self.progresses[key];
-        }
+- (void)removeResumeDataForDownload:(Download *)download
+{
+    NSString *filePath = [DownloadSession resumeDataFilePathForDownload:download];
+    if ([NSFileManager.defaultManager fileExistsAtPath:filePath]) {
+        [NSFileManager.defaultManager removeItemAtPath:filePath error:NULL];
     }
-    return nil;
 }
 
 #pragma mark NSURLSessionDownloadDelegate protocol
@@ -204,24 +552,28 @@ NSString * const DownloadProgressKey = @"DownloadProgress";
  totalBytesWritten:(int64_t)totalBytesWritten
 totalBytesExpectedToWrite:(int64_t)totalBytesExpectedToWrite
 {
+    DownloadSessionJob *job = nil;
+    @synchronized (self) {
+        job = self.runningJobs[@(downloadTask.taskIdentifier)];
+    }
+    
+    if (! job.media) {
+        return;
+    }
+    
     dispatch_async(dispatch_get_main_queue(), ^{
-        NSNumber *key = @(downloadTask.taskIdentifier);
-        
-        Download *download = self.downloads[key];
-        if ([downloadTask.originalRequest.URL isEqual:download.downloadMediaURL]) {
-            NSProgress *progress = self.progresses[key];
-            if (! progress) {
-                progress = [NSProgress progressWithTotalUnitCount:totalBytesExpectedToWrite];
-                self.progresses[key] = progress;
-            }
-            progress.totalUnitCount = totalBytesExpectedToWrite;
-            progress.completedUnitCount = totalBytesWritten;
-            
-            // Send notifications on behalf of the download
-            [NSNotificationCenter.defaultCenter postNotificationName:DownloadProgressDidChangeNotification
-                                                              object:download
-                                                            userInfo:@{ DownloadProgressKey : progress }];
+        NSProgress *progress = job.progress;
+        if (! progress) {
+            progress = [NSProgress progressWithTotalUnitCount:totalBytesExpectedToWrite];
+            job.progress = progress;
         }
+        progress.totalUnitCount = totalBytesExpectedToWrite;
+        progress.completedUnitCount = totalBytesWritten;
+        
+        // Send notifications on behalf of the download
+        [NSNotificationCenter.defaultCenter postNotificationName:DownloadProgressDidChangeNotification
+                                                          object:job.download
+                                                        userInfo:@{ DownloadProgressKey : progress }];
     });
 }
 
@@ -229,81 +581,103 @@ totalBytesExpectedToWrite:(int64_t)totalBytesExpectedToWrite
       downloadTask:(NSURLSessionDownloadTask *)downloadTask
 didFinishDownloadingToURL:(NSURL *)location
 {
-    NSNumber *key = @(downloadTask.taskIdentifier);
-    Download *download = self.downloads[key];
+    DownloadSessionJob *job = nil;
+    @synchronized (self) {
+        job = self.runningJobs[@(downloadTask.taskIdentifier)];
+    }
     
+    Download *download = job.download;
     if (download && [downloadTask.response isKindOfClass:NSHTTPURLResponse.class] && ((NSHTTPURLResponse *)downloadTask.response).statusCode == 200) {
-        if ([downloadTask.originalRequest.URL isEqual:download.downloadMediaURL]) {
+        if (job.media) {
             [download setLocalMediaFileWithTmpFile:location MIMEType:downloadTask.response.MIMEType];
         }
-        else if ([downloadTask.originalRequest.URL isEqual:download.downloadImageURL]) {
+        else {
             [download setLocalImageFileWithTmpFile:location MIMEType:downloadTask.response.MIMEType];
         }
     }
     
-    dispatch_async(dispatch_get_main_queue(), ^{
-        self.downloads[key] = nil;
-        self.progresses[key] = nil;
+    if (job) {
+        @synchronized (self) {
+            [self removeJob:job];
+            [self startPendingJobs];
+        }
         
         [self setNeedsStateUpdate];
         
-        [download setNeedsStateUpdate];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [download setNeedsStateUpdate];
+        });
+    }
+}
+
+#pragma mark NSURLSessionDelegate protocol
+
+- (void)URLSessionDidFinishEventsForBackgroundURLSession:(NSURLSession *)session
+{
+    dispatch_async(dispatch_get_main_queue(), ^{
+        void (^completionHandler)(void) = self.backgroundEventsCompletionHandler;
+        self.backgroundEventsCompletionHandler = nil;
+        if (completionHandler) {
+            completionHandler();
+        }
     });
 }
 
 #pragma mark NSURLSessionTaskDelegate protocol
 
-// Called with resume data at application start, if the application was killed by the user
-// See http://stackoverflow.com/a/32946198/760435
 - (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error
 {
-    // If resume data is available and can be bound to a download, replace any running task with a task starting from this
-    // data. This is not optimal, but since downloads are restarted before this delegate method is called, there is no reliable
-    // way of knowing whether resume data was available earlier. This should not harm, though, as this method should be called
-    // early after downloads have been restarted, probably before any data has been transferred
+    if (! error) {
+        return;
+    }
+    
     NSData *resumeData = error.userInfo[NSURLSessionDownloadTaskResumeData];
-    if (resumeData) {
-        NSPredicate *predicate = [NSPredicate predicateWithFormat:@"%K == %@", @keypath(Download.new, downloadMediaURL), task.originalRequest.URL];
-        Download *download = [Download.downloads filteredArrayUsingPredicate:predicate].firstObject;
-        if (download) {
-            [self.session getTasksWithCompletionHandler:^(NSArray<NSURLSessionDataTask *> * _Nonnull dataTasks, NSArray<NSURLSessionUploadTask *> * _Nonnull uploadTasks, NSArray<NSURLSessionDownloadTask *> * _Nonnull downloadTasks) {
-                [downloadTasks enumerateObjectsUsingBlock:^(NSURLSessionDownloadTask * _Nonnull task, NSUInteger idx, BOOL * _Nonnull stop) {
-                    if ([task.originalRequest.URL isEqual:download.downloadMediaURL] && task.state == NSURLSessionTaskStateRunning) {
-                        // Cancel the original request
-                        self.downloads[@(task.taskIdentifier)] = nil;
-                        [task cancel];
-                        
-                        // Replace with a new one using the resume data
-                        NSURLSessionDownloadTask *mediaFileTask = [self.session downloadTaskWithResumeData:resumeData];
-                        self.downloads[@(mediaFileTask.taskIdentifier)] = download;
-                        [mediaFileTask resume];
-                        
-                        [self setNeedsStateUpdate];
-                        
-                        *stop = YES;
-                    }
-                }];
-            }];
+    Download *failedDownload = nil;
+    NSURLSessionTask *replacedTask = nil;
+    
+    @synchronized (self) {
+        DownloadSessionJob *job = self.runningJobs[@(task.taskIdentifier)];
+        if (job) {
+            PlayLogError(@"download", @"Could not finish download correctly for %@. Reason: %@", task.originalRequest.URL.absoluteString, error);
+            
+            // If error occured (like a network error or SSL error), remove the download. Keep resume data so that the
+            // transfer continues where it stopped when the download is added again.
+            if (resumeData && job.media) {
+                [self saveResumeData:resumeData forDownload:job.download];
+            }
+            [self removeJob:job];
+            [self startPendingJobs];
+            
+            failedDownload = job.download;
         }
-    }
-    else if (error) {
-        PlayLogError(@"download", @"Could not finish download correctly for %@. Reason: %@", task.originalRequest.URL.absoluteString, error);
-        
-        NSNumber *key = @(task.taskIdentifier);
-        Download *download = self.downloads[key];
-        
-        // If error occured (like a network error or SSL error), remove the download.
-        if (download) {
-            dispatch_async(dispatch_get_main_queue(), ^{
-                self.downloads[key] = nil;
-                self.progresses[key] = nil;
-                
-                [self setNeedsStateUpdate];
+        // Called with resume data at application start, if the application was killed by the user
+        // See http://stackoverflow.com/a/32946198/760435
+        else if (resumeData && [error.userInfo[NSURLErrorBackgroundTaskCancelledReasonKey] integerValue] == NSURLErrorCancelledReasonUserForceQuitApplication) {
+            DownloadSessionJob *mediaJob = [self mediaJobForURN:task.taskDescription];
+            if (mediaJob && [mediaJob.URL isEqual:task.originalRequest.URL]) {
+                [self saveResumeData:resumeData forDownload:mediaJob.download];
                 
-                [download setNeedsStateUpdate];
-            });
+                // Pending jobs will start from resume data. If a transfer was restarted in the meantime, replace it with
+                // one starting from resume data. This should not harm, as this method should be called early after
+                // downloads have been restarted, probably before any data has been transferred.
+                if (mediaJob.task) {
+                    replacedTask = mediaJob.task;
+                    [self detachTaskFromJob:mediaJob];
+                    [self startJob:mediaJob];
+                }
+            }
         }
     }
+    
+    [replacedTask cancel];
+    
+    if (failedDownload) {
+        [self setNeedsStateUpdate];
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [failedDownload setNeedsStateUpdate];
+        });
+    }
 }
 
 #pragma mark Notifications
@@ -312,13 +686,63 @@ didFinishDownloadingToURL:(NSURL *)location
 {
     [self setNeedsStateUpdate];
     
-    NSSet<Download *> *downloadsSet = [NSSet setWithArray:[self.downloads allValues]];
-    [downloadsSet enumerateObjectsUsingBlock:^(Download * _Nonnull download, BOOL * _Nonnull stop) {
+    NSMutableSet<Download *> *downloads = [NSMutableSet set];
+    BOOL downloadsRestored = NO;
+    @synchronized (self) {
+        downloadsRestored = self.downloadsRestored;
+        for (NSArray<DownloadSessionJob *> *jobs in self.jobsByURN.allValues) {
+            [downloads addObject:jobs.firstObject.download];
+        }
+        
+        // Apply the limit of the new network
+        [self startPendingJobs];
+    }
+    
+    [downloads enumerateObjectsUsingBlock:^(Download * _Nonnull download, BOOL * _Nonnull stop) {
         [download setNeedsStateUpdate];
     }];
     
-    if (ReachabilityBecameReachable(notification)) {
-        [self restoreSessionState];
+    if (ReachabilityBecameReachable(notification) && downloadsRestored) {
+        [self synchronizeTasks];
+    }
+}
+
+@end
+
+@implementation DownloadSessionJob
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithDownload:(Download *)download media:(BOOL)media priority:(DownloadSessionJobPriority)priority sequenceNumber:(NSUInteger)sequenceNumber
+{
+    if (self = [super init]) {
+        _download = download;
+        _media = media;
+        _priority = priority;
+        _sequenceNumber = sequenceNumber;
+    }
+    return self;
+}
+
+#pragma mark Getters and setters
+
+- (NSURL *)URL
+{
+    return self.media ? self.download.downloadMediaURL : self.download.downloadImageURL;
+}
+
+#pragma mark Comparison
+
+- (NSComparisonResult)compare:(DownloadSessionJob *)job
+{
+    if (self.priority != job.priority) {
+        return (self.priority < job.priority) ? NSOrderedAscending : NSOrderedDescending;
+    }
+    else if (self.sequenceNumber != job.sequenceNumber) {
+        return (self.sequenceNumber < job.sequenceNumber) ? NSOrderedAscending : NSOrderedDescending;
+    }
+    else {
+        return NSOrderedSame;
     }
 }
 
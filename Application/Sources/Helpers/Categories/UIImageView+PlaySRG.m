@@ -8,12 +8,14 @@
 
 #import "NSBundle+PlaySRG.h"
 #import "PlayErrors.h"
+#import "PlaySRG-Swift.h"
 
 #import <objc/runtime.h>
 
 @import SRGAppearance;
 @import SRGDataProviderNetwork;
-@import YYWebImage;
+
+static void *s_imageURLKey = &s_imageURLKey;
 
 @implementation UIImageView (PlaySRG)
 
@@ -55,7 +57,47 @@
     return imageView;
 }
 
+// Tinted frames are rendered once and kept in a cache, purged under memory pressure
++ (NSCache<NSString *, NSArray<UIImage *> *> *)animatedImagesCache
+{
+    static NSCache<NSString *, NSArray<UIImage *> *> *s_cache;
+    static dispatch_once_t s_onceToken;
+    dispatch_once(&s_onceToken, ^{
+        s_cache = [[NSCache alloc] init];
+        s_cache.countLimit = 50;
+        
+        [NSNotificationCenter.defaultCenter addObserverForName:UIApplicationDidReceiveMemoryWarningNotification object:nil queue:nil usingBlock:^(NSNotification * _Nonnull notification) {
+            [s_cache removeAllObjects];
+        }];
+    });
+    return s_cache;
+}
+
++ (NSString *)animatedImagesKeyForName:(NSString *)name tintColor:(UIColor *)tintColor
+{
+    UITraitCollection *traitCollection = UITraitCollection.currentTraitCollection;
+    UIColor *resolvedTintColor = [tintColor resolvedColorWithTraitCollection:traitCollection];
+    
+    CGFloat red = 0.f, green = 0.f, blue = 0.f, alpha = 0.f;
+    NSString *colorKey = [resolvedTintColor getRed:&red green:&green blue:&blue alpha:&alpha] ? [NSString stringWithFormat:@"%.3f-%.3f-%.3f-%.3f", red, green, blue, alpha] : resolvedTintColor.description;
+    return [NSString stringWithFormat:@"%@_%@_%@", name, colorKey, @(traitCollection.displayScale)];
+}
+
 + (NSArray<UIImage *> *)animatedImageNamed:(NSString *)name withTintColor:(UIColor *)tintColor
+{
+    NSCache<NSString *, NSArray<UIImage *> *> *cache = [self animatedImagesCache];
+    NSString *key = [self animatedImagesKeyForName:name tintColor:tintColor];
+    NSArray<UIImage *> *cachedImages = [cache objectForKey:key];
+    if (cachedImages) {
+        return cachedImages;
+    }
+    
+    NSArray<UIImage *> *images = [self renderedAnimatedImageNamed:name withTintColor:tintColor];
+    [cache setObject:images forKey:key];
+    return images;
+}
+
++ (NSArray<UIImage *> *)renderedAnimatedImageNamed:(NSString *)name withTintColor:(UIColor *)tintColor
 {
     NSMutableArray<UIImage *> *images = [NSMutableArray array];
     
@@ -156,7 +198,7 @@
             unavailabilityHandler();
         }
         else {
-            [self yy_setImageWithURL:nil placeholder:placeholderImage];
+            [self play_setImageURL:nil placeholder:placeholderImage];
         }
     };
     
@@ -175,26 +217,8 @@
         return;
     }
     
-    if (! [URL isEqual:self.yy_imageURL]) {
-        // If an image is already displayed, use it as placeholder. This make the transition smooth between both images.
-        // Using the placeholder would add an unnecessary intermediate state leading to flickering
-        if (self.image) {
-            [self yy_setImageWithURL:URL placeholder:self.image options:YYWebImageOptionSetImageWithFadeAnimation completion:nil];
-        }
-        // If no image is already displayed, check if the image we want to display is already available from the cache.
-        // If this is the case, use it as placeholder, avoiding an intermediate step which would lead to flickering
-        else {
-            YYWebImageManager *webImageManager = YYWebImageManager.sharedManager;
-            NSString *key = [webImageManager cacheKeyForURL:URL];
-            UIImage *image = [webImageManager.cache getImageForKey:key];
-            if (image) {
-                // Use the YYWebImage setter so that the URL is properly associated with the image view
-                [self yy_setImageWithURL:URL placeholder:image options:YYWebImageOptionSetImageWithFadeAnimation completion:nil];
-            }
-            else {
-                [self yy_setImageWithURL:URL placeholder:placeholderImage options:YYWebImageOptionSetImageWithFadeAnimation completion:nil];
-            }
-        }
+    if (! [URL isEqual:objc_getAssociatedObject(self, s_imageURLKey)]) {
+        [self play_setImageURL:URL placeholder:placeholderImage];
     }
 }
 
@@ -208,7 +232,22 @@
 
 - (void)play_resetImage
 {
-    [self yy_setImageWithURL:nil options:0];
+    [self play_setImageURL:nil placeholder:nil];
+}
+
+// Images are loaded with the image pipeline shared with SwiftUI image views. If an image is already displayed or
+// available from the memory cache, it is used as placeholder, making the transition between both images smooth.
+- (void)play_setImageURL:(NSURL *)URL placeholder:(UIImage *)placeholderImage
+{
+    objc_setAssociatedObject(self, s_imageURLKey, URL, OBJC_ASSOCIATION_COPY_NONATOMIC);
+    
+    if (URL) {
+        [ImageLoader loadImageWith:URL placeholder:placeholderImage into:self];
+    }
+    else {
+        [ImageLoader cancelRequestFor:self];
+        self.image = placeholderImage;
+    }
 }
 
 - (void)play_fixImageTintColor
@@ -14,7 +14,9 @@ typedef void (^ChannelServiceUpdateBlock)(SRGProgramComposition * _Nullable prog
 
 /**
  *  Service responsible for retrieving and broadcasting channel detailed information (program information, mostly).
- *  The service periodically retrieves channel data, caches it, and notifies registered observers.
+ *  The service retrieves channel data, caches it, and notifies registered observers. Only channels with observers
+ *  are refreshed, when their current program ends (or periodically if no program information is available), with
+ *  an exponential backoff in case of failure.
  */
 @interface ChannelService : NSObject
 
@@ -35,6 +37,11 @@ typedef void (^ChannelServiceUpdateBlock)(SRGProgramComposition * _Nullable prog
  */
 - (void)removeObserver:(nullable id)observer;
 
+/**
+ *  The total number of program requests made by the service since the application was launched.
+ */
+@property (nonatomic, readonly) NSUInteger numberOfRequests;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -8,12 +8,26 @@
 
 #import "ChannelServiceSetup.h"
 #import "ForegroundTimer.h"
+#import "PlayLogger.h"
 #import "Reachability.h"
 #import "PlaySRG-Swift.h"
 
 @import libextobjc;
 @import SRGDataProviderNetwork;
 
+// Refresh interval bounds. Channels are refreshed when their current program ends, within these bounds.
+static const NSTimeInterval kMinimumRefreshInterval = 30.;
+static const NSTimeInterval kMaximumRefreshInterval = 5. * 60.;
+
+// Refresh interval for channels without current program information.
+static const NSTimeInterval kDefaultRefreshInterval = 60.;
+
+// Delay applied after a program end before refreshing, so that the next program is available.
+static const NSTimeInterval kProgramEndRefreshDelay = 5.;
+
+// Refreshes due within this tolerance are grouped together.
+static const NSTimeInterval kRefreshTolerance = 5.;
+
 @interface ChannelService ()
 
 @property (nonatomic) NSMutableDictionary<ChannelServiceSetup *, NSMutableDictionary<NSString *, ChannelServiceUpdateBlock> *> *registrations;
@@ -22,9 +36,16 @@
 // data is used to return existing channel information as fast as possible, and when errors have been encountered.
 @property (nonatomic) NSMutableDictionary<ChannelServiceSetup *, SRGProgramComposition *> *programCompositions;
 
+@property (nonatomic) NSMutableDictionary<ChannelServiceSetup *, NSDate *> *nextRefreshDates;
+@property (nonatomic) NSMutableDictionary<ChannelServiceSetup *, NSNumber *> *failureCounts;
+@property (nonatomic) NSMutableSet<ChannelServiceSetup *> *pendingSetups;
+
 @property (nonatomic) ForegroundTimer *updateTimer;
+@property (nonatomic) NSDate *updateDate;
 @property (nonatomic) SRGRequestQueue *requestQueue;
 
+@property (nonatomic) NSUInteger numberOfRequests;
+
 @end
 
 @implementation ChannelService
@@ -48,13 +69,10 @@
     if (self = [super init]) {
         self.registrations = [NSMutableDictionary dictionary];
         self.programCompositions = [NSMutableDictionary dictionary];
-        
-        @weakify(self)
-        self.updateTimer = [ForegroundTimer timerWithTimeInterval:30. repeats:YES block:^(ForegroundTimer * _Nonnull timer) {
-            @strongify(self)
-            [self updateChannels];
-        }];
-        [self updateChannels];
+        self.nextRefreshDates = [NSMutableDictionary dictionary];
+        self.failureCounts = [NSMutableDictionary dictionary];
+        self.pendingSetups = [NSMutableSet set];
+        self.requestQueue = [[SRGRequestQueue alloc] init];
         
         [NSNotificationCenter.defaultCenter addObserver:self
                                                selector:@selector(reachabilityDidChange:)
@@ -85,15 +103,12 @@
     if (channel.vendor == SRGVendorSSATR) {
         return nil;
     }
-
-    BOOL channelAdded = NO;
     
     ChannelServiceSetup *setup = [[ChannelServiceSetup alloc] initWithChannel:channel livestreamUid:livestreamUid];
     NSMutableDictionary<NSString *, ChannelServiceUpdateBlock> *channelRegistrations = self.registrations[setup];
     if (! channelRegistrations) {
         channelRegistrations = [NSMutableDictionary dictionary];
         self.registrations[setup] = channelRegistrations;
-        channelAdded = YES;
     }
     
     NSString *identifier = NSUUID.UUID.UUIDString;
@@ -105,10 +120,14 @@
         block(programComposition);
     }
     
-    // Trigger an update the first time a channel is added. Other updates will occur perodically afterwards.
-    if (channelAdded) {
+    // Refresh immediately if no up-to-date data is available. Other updates will occur when needed afterwards.
+    NSDate *nextRefreshDate = self.nextRefreshDates[setup];
+    if (! nextRefreshDate || [nextRefreshDate compare:NSDate.date] != NSOrderedDescending) {
         [self refreshWithSetup:setup];
     }
+    else {
+        [self scheduleUpdate];
+    }
     
     return identifier;
 }
@@ -119,30 +138,65 @@
         return;
     }
     
-    for (NSMutableDictionary<NSString *, ChannelServiceUpdateBlock> *channelRegistrations in self.registrations.allValues) {
+    for (ChannelServiceSetup *setup in self.registrations.allKeys) {
+        NSMutableDictionary<NSString *, ChannelServiceUpdateBlock> *channelRegistrations = self.registrations[setup];
         [channelRegistrations removeObjectForKey:observer];
+        
+        // Channels without observers are not refreshed anymore. Their cached data and next refresh date are kept so
+        // that adding an observer again does not trigger an update if data is still up-to-date.
+        if (channelRegistrations.count == 0) {
+            [self.registrations removeObjectForKey:setup];
+        }
     }
     
-    // Keep registered channels for the lifetime of the app, do not remove associated entries (otherwise we might
-    // remove and add channels repeatedly, triggering an update each time)
+    [self scheduleUpdate];
 }
 
 #pragma mark Data retrieval
 
+- (NSDate *)nextRefreshDateForProgramComposition:(SRGProgramComposition *)programComposition
+{
+    NSDate *currentDate = NSDate.date;
+    SRGProgram *currentProgram = [programComposition play_programAt:currentDate];
+    NSTimeInterval interval = currentProgram ? [currentProgram.endDate timeIntervalSinceDate:currentDate] + kProgramEndRefreshDelay : kDefaultRefreshInterval;
+    return [currentDate dateByAddingTimeInterval:fmin(fmax(interval, kMinimumRefreshInterval), kMaximumRefreshInterval)];
+}
+
+- (NSDate *)nextRefreshDateForFailureCount:(NSUInteger)failureCount
+{
+    NSTimeInterval interval = kMinimumRefreshInterval * pow(2., failureCount - 1);
+    return [NSDate.date dateByAddingTimeInterval:fmin(interval, kMaximumRefreshInterval)];
+}
+
 - (void)refreshWithSetup:(ChannelServiceSetup *)setup
 {
+    if ([self.pendingSetups containsObject:setup]) {
+        return;
+    }
+    
     @weakify(self)
     SRGPaginatedProgramCompositionCompletionBlock completionBlock = ^(SRGProgramComposition * _Nullable programComposition, SRGPage *page, SRGPage * _Nullable nextPage, NSHTTPURLResponse * _Nullable HTTPResponse, NSError * _Nullable error) {
         @strongify(self)
         
+        [self.pendingSetups removeObject:setup];
+        
         if (programComposition) {
             self.programCompositions[setup] = programComposition;
+            self.nextRefreshDates[setup] = [self nextRefreshDateForProgramComposition:programComposition];
+            [self.failureCounts removeObjectForKey:setup];
+        }
+        else {
+            NSUInteger failureCount = self.failureCounts[setup].unsignedIntegerValue + 1;
+            self.failureCounts[setup] = @(failureCount);
+            self.nextRefreshDates[setup] = [self nextRefreshDateForFailureCount:failureCount];
         }
         
         NSMutableDictionary<NSString *, ChannelServiceUpdateBlock> *channelRegistrations = self.registrations[setup];
         for (ChannelServiceUpdateBlock updateBlock in channelRegistrations.allValues) {
             updateBlock(self.programCompositions[setup]);
         }
+        
+        [self scheduleUpdate];
     };
     
     static const NSUInteger kPageSize = 50;
@@ -154,16 +208,59 @@
     else {
         request = [[SRGDataProvider.currentDataProvider tvLatestProgramsForVendor:setup.channel.vendor channelUid:setup.channel.uid livestreamUid:setup.livestreamUid fromDate:nil toDate:nil withCompletionBlock:completionBlock] requestWithPageSize:kPageSize];
     }
+    [self.pendingSetups addObject:setup];
     [self.requestQueue addRequest:request resume:YES];
+    
+    self.numberOfRequests += 1;
+    PlayLogDebug(@"channels", @"Refreshing %@ (%@ requests so far)", setup, @(self.numberOfRequests));
 }
 
 - (void)updateChannels
 {
-    self.requestQueue = [[SRGRequestQueue alloc] init];
+    // Refresh all observed channels which are due, grouping refreshes due at close dates
+    NSDate *dueDate = [NSDate.date dateByAddingTimeInterval:kRefreshTolerance];
+    for (ChannelServiceSetup *setup in self.registrations.allKeys) {
+        NSDate *nextRefreshDate = self.nextRefreshDates[setup];
+        if (! nextRefreshDate || [nextRefreshDate compare:dueDate] != NSOrderedDescending) {
+            [self refreshWithSetup:setup];
+        }
+    }
     
+    [self scheduleUpdate];
+}
+
+- (void)scheduleUpdate
+{
+    NSDate *nextRefreshDate = nil;
     for (ChannelServiceSetup *setup in self.registrations) {
-        [self refreshWithSetup:setup];
+        if ([self.pendingSetups containsObject:setup]) {
+            continue;
+        }
+        
+        NSDate *setupNextRefreshDate = self.nextRefreshDates[setup];
+        if (setupNextRefreshDate && (! nextRefreshDate || [setupNextRefreshDate compare:nextRefreshDate] == NSOrderedAscending)) {
+            nextRefreshDate = setupNextRefreshDate;
+        }
+    }
+    
+    if (! nextRefreshDate) {
+        self.updateTimer = nil;
+        self.updateDate = nil;
+        return;
+    }
+    
+    if ([nextRefreshDate isEqualToDate:self.updateDate]) {
+        return;
     }
+    
+    self.updateDate = nextRefreshDate;
+    
+    @weakify(self)
+    self.updateTimer = [ForegroundTimer timerWithTimeInterval:fmax(nextRefreshDate.timeIntervalSinceNow, 1.) repeats:NO block:^(ForegroundTimer * _Nonnull timer) {
+        @strongify(self)
+        self.updateDate = nil;
+        [self updateChannels];
+    }];
 }
 
 #pragma mark Notifications
@@ -171,6 +268,12 @@
 - (void)reachabilityDidChange:(NSNotification *)notification
 {
     if (ReachabilityBecameReachable(notification)) {
+        // Retry failed refreshes immediately
+        for (ChannelServiceSetup *setup in self.failureCounts) {
+            [self.nextRefreshDates removeObjectForKey:setup];
+        }
+        [self.failureCounts removeAllObjects];
+        
         [self updateChannels];
     }
 }
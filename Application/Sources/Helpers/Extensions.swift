@@ -35,6 +35,131 @@ func removeDuplicates<T: Hashable>(in items: [T]) -> [T] {
     }
 }
 
+/**
+ *  Changes applied to a list of items, e.g. as a result of user interaction. Change sets delivered by a publisher have
+ *  increasing versions.
+ */
+struct ItemChangeSet<T: Hashable> {
+    let version: Int
+    let insertedItems: [T]
+    let removedItems: [T]
+}
+
+/**
+ *  Incremental accumulation of paginated items. Pages are appended as deltas against a persistent set of already seen
+ *  items, so that duplicates are discarded without rescanning previously received pages. Removed items are applied
+ *  against a set as well and only trigger a full pass over accumulated items when previously removed items reappear.
+ */
+final class ItemAccumulator<T: Hashable> {
+    enum Update {
+        case append([T])
+        case replace([T])
+        case changes(ItemChangeSet<T>)
+    }
+
+    private var storage = [T]()
+    private var seenItems = Set<T>()
+    private var removedItems = Set<T>()
+    private var changeSetVersion: Int?
+
+    /// Accumulated items, without duplicates and removed items.
+    private(set) var items = [T]()
+    /// `true` iff at least one page has been accumulated.
+    private(set) var hasPages = false
+
+    func append(_ page: [T]) {
+        hasPages = true
+        for item in page {
+            guard seenItems.insert(item).inserted else {
+                PlayLogWarning(category: "duplicates", message: "A duplicate item has been removed: \(item)")
+                continue
+            }
+            storage.append(item)
+            if !removedItems.contains(item) {
+                items.append(item)
+            }
+        }
+    }
+
+    /// Replace all accumulated pages with a single page. Applied changes are kept.
+    func replace(with page: [T]) {
+        storage.removeAll()
+        seenItems.removeAll()
+        items.removeAll()
+        append(page)
+    }
+
+    /// Apply a change set, returning `true` iff accumulated items changed. Inserted items are only restored if they
+    /// had been removed before, at their original position. Change sets older than the last applied one are ignored.
+    @discardableResult
+    func apply(_ changeSet: ItemChangeSet<T>) -> Bool {
+        if let changeSetVersion, changeSet.version <= changeSetVersion {
+            return false
+        }
+        changeSetVersion = changeSet.version
+
+        var isRestoringItems = false
+        for item in changeSet.insertedItems where removedItems.remove(item) != nil && seenItems.contains(item) {
+            isRestoringItems = true
+        }
+
+        var newlyRemovedItems = Set<T>()
+        for item in changeSet.removedItems where removedItems.insert(item).inserted && seenItems.contains(item) {
+            newlyRemovedItems.insert(item)
+        }
+
+        if isRestoringItems {
+            items = storage.filter { !removedItems.contains($0) }
+            return true
+        } else if !newlyRemovedItems.isEmpty {
+            items.removeAll { newlyRemovedItems.contains($0) }
+            return true
+        } else {
+            return false
+        }
+    }
+
+    /// Apply an update, returning `true` iff accumulated items changed.
+    @discardableResult
+    func apply(_ update: Update) -> Bool {
+        switch update {
+        case let .append(page):
+            append(page)
+            return true
+        case let .replace(page):
+            replace(with: page)
+            return true
+        case let .changes(changeSet):
+            return apply(changeSet)
+        }
+    }
+}
+
+extension Publisher {
+    /**
+     *  Accumulate pages of items emitted by the upstream publisher, discarding duplicates and applying the changes
+     *  emitted by the change set publisher. Nothing is emitted until a first page has been received. If `replacingPages`
+     *  is `true`, each list emitted by the upstream publisher replaces all items received before instead.
+     */
+    func accumulateItems<T: Hashable>(applying changeSetPublisher: AnyPublisher<ItemChangeSet<T>, Never>, replacingPages: Bool = false) -> AnyPublisher<[T], Failure> where Output == [T] {
+        // Use a deferred publisher so that each subscription gets its own accumulator
+        return Deferred { [self] in
+            let accumulator = ItemAccumulator<T>()
+            return Publishers.Merge(
+                map { replacingPages ? ItemAccumulator<T>.Update.replace($0) : ItemAccumulator<T>.Update.append($0) },
+                changeSetPublisher
+                    .map { ItemAccumulator<T>.Update.changes($0) }
+                    .setFailureType(to: Failure.self)
+            )
+            .compactMap { update -> [T]? in
+                let hasChanged = accumulator.apply(update)
+                return accumulator.hasPages && hasChanged ? accumulator.items : nil
+            }
+        }
+        .eraseToAnyPublisher()
+    }
+}
+
 func url(for image: SRGImage?, size: SRGImageSize) -> URL? {
     SRGDataProvider.current!.url(for: image, size: size)
 }
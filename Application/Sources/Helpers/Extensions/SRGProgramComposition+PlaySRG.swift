@@ -6,12 +6,33 @@
 
 import SRGDataProviderModel
 
+private var timelineKey: Void?
+
 extension SRGProgramComposition {
+    /**
+     *  Programs indexed by date and media URN. Built once per composition, since compositions are immutable.
+     */
+    private var timeline: ProgramTimeline {
+        if let timeline = objc_getAssociatedObject(self, &timelineKey) as? ProgramTimeline {
+            return timeline
+        }
+        let timeline = ProgramTimeline(programs: programs ?? [])
+        objc_setAssociatedObject(self, &timelineKey, timeline, .OBJC_ASSOCIATION_RETAIN)
+        return timeline
+    }
+
     /**
      *  Return the program at the specified date, if any.
      */
     @objc func play_program(at date: Date) -> SRGProgram? {
-        programs?.first(where: { $0.play_containsDate(date) })
+        timeline.program(at: date)
+    }
+
+    /**
+     *  Return the program associated with the specified media URN, if any.
+     */
+    @objc func play_program(withMediaURN mediaURN: String) -> SRGProgram? {
+        timeline.program(withMediaUrn: mediaURN)
     }
 
     /**
@@ -19,21 +40,127 @@ extension SRGProgramComposition {
      *  are provided, only matching programs will be returned.
      */
     @objc func play_programs(from fromDate: Date?, to toDate: Date?, withMediaURNs mediaURNs: [String]?) -> [SRGProgram] {
-        programs?.filter { program in
-            if let fromDate, program.startDate < fromDate {
-                return false
+        let programs = timeline.programs(from: fromDate, to: toDate)
+        if let mediaURNs {
+            let mediaUrns = Set(mediaURNs)
+            return programs.filter { program in
+                guard let mediaUrn = program.mediaURN else { return false }
+                return mediaUrns.contains(mediaUrn)
             }
+        } else {
+            return programs
+        }
+    }
+}
+
+/**
+ *  Programs sorted by start date, for lookups by binary search. The result of the last date lookup is kept with the
+ *  range of dates for which it stays valid, so that repeated lookups (e.g. periodic updates) are immediate.
+ */
+private final class ProgramTimeline {
+    private struct Hint {
+        let dateInterval: DateInterval
+        let program: SRGProgram?
+    }
+
+    private let programs: [SRGProgram]
+    private let startDates: [Date]
+    private let endDates: [Date]
+    /// Latest end date among programs up to each index, to find overlapping programs
+    private let maximumEndDates: [Date]
+    private let programsByMediaUrn: [String: SRGProgram]
+
+    private var hint: Hint?
+    private let lock = NSLock()
+
+    init(programs: [SRGProgram]) {
+        // Avoid issues if data is incorrect, like `SRGProgram.play_containsDate(_:)`
+        let sortedPrograms = programs
+            .map { (program: $0, startDate: min($0.startDate, $0.endDate), endDate: max($0.startDate, $0.endDate)) }
+            .sorted { $0.startDate < $1.startDate }
 
-            if let toDate, toDate < program.startDate {
-                return false
+        self.programs = sortedPrograms.map(\.program)
+        startDates = sortedPrograms.map(\.startDate)
+        endDates = sortedPrograms.map(\.endDate)
+
+        var maximumEndDate = Date.distantPast
+        maximumEndDates = endDates.map { endDate in
+            maximumEndDate = max(maximumEndDate, endDate)
+            return maximumEndDate
+        }
+
+        var programsByMediaUrn = [String: SRGProgram]()
+        for program in programs {
+            guard let mediaUrn = program.mediaURN, programsByMediaUrn[mediaUrn] == nil else { continue }
+            programsByMediaUrn[mediaUrn] = program
+        }
+        self.programsByMediaUrn = programsByMediaUrn
+    }
+
+    func program(at date: Date) -> SRGProgram? {
+        if let hint = synchronized({ hint }), hint.dateInterval.contains(date) {
+            return hint.program
+        }
+
+        let hint = lookup(date)
+        synchronized {
+            self.hint = hint
+        }
+        return hint.program
+    }
+
+    func program(withMediaUrn mediaUrn: String) -> SRGProgram? {
+        programsByMediaUrn[mediaUrn]
+    }
+
+    func programs(from fromDate: Date?, to toDate: Date?) -> [SRGProgram] {
+        let lowerIndex = fromDate.map { index(after: $0, orEqual: false) } ?? 0
+        let upperIndex = toDate.map { index(after: $0, orEqual: true) } ?? programs.count
+        guard lowerIndex < upperIndex else { return [] }
+        return Array(programs[lowerIndex..<upperIndex])
+    }
+
+    /// Index of the first program starting after the date (or at the date if `orEqual` is `false`).
+    private func index(after date: Date, orEqual: Bool) -> Int {
+        var lowerIndex = 0
+        var upperIndex = startDates.count
+        while lowerIndex < upperIndex {
+            let index = (lowerIndex + upperIndex) / 2
+            if startDates[index] < date || (orEqual && startDates[index] == date) {
+                lowerIndex = index + 1
+            } else {
+                upperIndex = index
             }
+        }
+        return lowerIndex
+    }
 
-            if let mediaURNs {
-                guard let mediaUrn = program.mediaURN else { return false }
-                return mediaURNs.contains(mediaUrn)
+    private func lookup(_ date: Date) -> Hint {
+        // Programs starting after the date cannot contain it
+        let nextIndex = index(after: date, orEqual: true)
+        let nextStartDate = (nextIndex < startDates.count) ? startDates[nextIndex] : Date.distantFuture
+
+        // Find the latest program containing the date, stopping as soon as no earlier program can contain it
+        var index = nextIndex - 1
+        while index >= 0, maximumEndDates[index] >= date {
+            if endDates[index] >= date {
+                // Programs skipped in between might contain earlier dates
+                let startDate = (index == nextIndex - 1) ? startDates[index] : date
+                let endDate = min(endDates[index], nextStartDate.addingTimeInterval(-0.001))
+                return Hint(dateInterval: DateInterval(start: startDate, end: max(startDate, endDate)), program: programs[index])
             }
+            index -= 1
+        }
+
+        // No program at this date. The result stays valid until the next program starts.
+        let previousEndDate = (nextIndex > 0) ? maximumEndDates[nextIndex - 1] : Date.distantPast
+        let startDate = min(previousEndDate.addingTimeInterval(0.001), date)
+        return Hint(dateInterval: DateInterval(start: startDate, end: max(startDate, nextStartDate.addingTimeInterval(-0.001))), program: nil)
+    }
 
-            return true
-        } ?? []
+    private func synchronized<T>(_ block: () -> T) -> T {
+        lock.lock()
+        defer { lock.unlock() }
+        return block()
     }
 }
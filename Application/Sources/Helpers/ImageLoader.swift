@@ -0,0 +1,127 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+import Nuke
+import UIKit
+
+/**
+ *  Single image pipeline used by the whole application, SwiftUI image views as well as legacy `UIImageView`s,
+ *  with a disk cache of bounded size.
+ */
+@objc final class ImageLoader: NSObject {
+    private static let diskCacheSizeLimit = constant(iOS: 150, tvOS: 100) * 1024 * 1024
+
+    /// Cost limit (in bytes) of decoded images kept in memory. Images are downsampled to their display size (see
+    /// `ImageView`), so that more images fit.
+    private static let memoryCacheCostLimit = constant(iOS: 100, tvOS: 150) * 1024 * 1024
+
+    /**
+     *  Setup the shared image pipeline. Must be called before any image is loaded.
+     */
+    @objc static func setup() {
+        var configuration = ImagePipeline.Configuration.withDataCache
+        if let dataCache = try? DataCache(name: "ch.srgssr.play.images") {
+            dataCache.sizeLimit = diskCacheSizeLimit
+            configuration.dataCache = dataCache
+        }
+        configuration.imageCache = ImageCache(costLimit: memoryCacheCostLimit)
+        ImagePipeline.shared = ImagePipeline(configuration: configuration)
+
+        PlayApplicationRunOnce({ completionHandler in
+            removeLegacyDiskCache()
+            completionHandler(true)
+        }, "LegacyImageCacheRemoval")
+    }
+
+    /// Remove the disk cache of the image library formerly used (YYWebImage).
+    private static func removeLegacyDiskCache() {
+        DispatchQueue.global(qos: .background).async {
+            guard let cachesDirectoryUrl = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask).first else { return }
+            try? FileManager.default.removeItem(at: cachesDirectoryUrl.appendingPathComponent("com.ibireme.yykit", isDirectory: true))
+        }
+    }
+
+    /**
+     *  Load an image into an image view, cancelling any image previously requested for it. The placeholder is displayed
+     *  until the image is available, except if an image is already displayed, in which case it is kept to avoid
+     *  flickering.
+     */
+    @objc static func loadImage(with url: URL?, placeholder: UIImage?, into imageView: UIImageView) {
+        let options = ImageLoadingOptions(
+            placeholder: imageView.image ?? cachedImage(for: url) ?? placeholder,
+            transition: .fadeIn(duration: 0.2),
+            failureImage: placeholder
+        )
+        Nuke.loadImage(with: url, options: options, into: imageView)
+    }
+
+    /**
+     *  Cancel any image request associated with an image view.
+     */
+    @objc static func cancelRequest(for imageView: UIImageView) {
+        Nuke.cancelRequest(for: imageView)
+    }
+
+    /**
+     *  Return the image available in memory for the specified URL, if any.
+     */
+    @objc static func cachedImage(for url: URL?) -> UIImage? {
+        guard let url else { return nil }
+        return ImagePipeline.shared.cache[url]?.image
+    }
+
+    /**
+     *  Remove all images from memory and disk caches.
+     */
+    @objc static func removeAllCachedImages() {
+        ImagePipeline.shared.configuration.imageCache?.removeAll()
+        ImagePipeline.shared.configuration.dataCache?.removeAll()
+    }
+}
+
+/**
+ *  Prefetches images about to be displayed, e.g. for items reported by `UICollectionViewDataSourcePrefetching`.
+ *  Prefetching is cancelled when the scroll direction changes, since prefetched images are then unlikely to be needed
+ *  soon.
+ */
+final class ContentImagePrefetcher {
+    private enum Direction {
+        case none
+        case forward
+        case backward
+    }
+
+    // Only fetch image data. Images are decoded when displayed, at their display size.
+    private let prefetcher = ImagePrefetcher(pipeline: ImagePipeline.shared, destination: .diskCache, maxConcurrentRequestCount: 4)
+    private var direction: Direction = .none
+    private var lastOffset: CGFloat?
+
+    func startPrefetching(with urls: [URL]) {
+        guard !urls.isEmpty else { return }
+        prefetcher.startPrefetching(with: urls)
+    }
+
+    func stopPrefetching(with urls: [URL]) {
+        guard !urls.isEmpty else { return }
+        prefetcher.stopPrefetching(with: urls)
+    }
+
+    /**
+     *  Must be called when the content offset changes along the main scrolling axis.
+     */
+    func updateOffset(_ offset: CGFloat) {
+        defer {
+            lastOffset = offset
+        }
+
+        guard let lastOffset, offset != lastOffset else { return }
+        let direction: Direction = (offset > lastOffset) ? .forward : .backward
+        if self.direction != .none, direction != self.direction {
+            prefetcher.stopPrefetching()
+        }
+        self.direction = direction
+    }
+}
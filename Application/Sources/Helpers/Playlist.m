@@ -73,6 +73,7 @@ static Playlist *s_playlist;
     NSURLComponents *URLComponents = [NSURLComponents componentsWithString:URL.absoluteString];
     URLComponents.queryItems = @[ [NSURLQueryItem queryItemWithName:@"standalone" value:@"false"] ];
     
+    @weakify(self)
     SRGRequest *recommendationRequest = [[SRGRequest objectRequestWithURLRequest:[NSURLRequest requestWithURL:URLComponents.URL] session:NSURLSession.sharedSession parser:^id _Nullable(NSData * _Nonnull data, NSError * _Nullable __autoreleasing * _Nullable pError) {
         NSDictionary *JSONDictionary = SRGNetworkJSONDictionaryParser(data, pError);
         if (! JSONDictionary) {
@@ -85,8 +86,11 @@ static Playlist *s_playlist;
             return;
         }
         
-        SRGBaseRequest *mediasRequest = [[SRGDataProvider.currentDataProvider mediasWithURNs:recommendation.URNs completionBlock:^(NSArray<SRGMedia *> * _Nullable medias, SRGPage * _Nonnull page, SRGPage * _Nullable nextPage, NSHTTPURLResponse * _Nullable HTTPResponse, NSError * _Nullable error) {
-            if (error) {
+        [MediaHydrationService.shared mediasWithURNs:recommendation.URNs completion:^(NSArray<SRGMedia *> * _Nullable medias, NSError * _Nullable error) {
+            @strongify(self)
+            
+            // Ignore results received after the playlist has been replaced
+            if (error || ! self || s_playlist != self) {
                 return;
             }
             
@@ -96,8 +100,7 @@ static Playlist *s_playlist;
                 return HistoryCanResumePlaybackForMedia(media);
             }];
             self.medias = [medias filteredArrayUsingPredicate:predicate];
-        }] requestWithPageSize:50];
-        [self.requestQueue addRequest:mediasRequest resume:YES];
+        }];
     }] requestWithOptions:SRGRequestOptionBackgroundCompletionEnabled];
     [self.requestQueue addRequest:recommendationRequest resume:YES];
 }
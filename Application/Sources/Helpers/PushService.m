@@ -234,7 +234,7 @@ NSString * const PushServiceEnabledKey = @"PushServiceEnabled";
 
 - (void)updateApplicationBadge
 {
-    NSInteger unreadNotificationCount = UserNotification.unreadNotifications.count;
+    NSInteger unreadNotificationCount = UserNotification.unreadNotificationCount;
     
     if (UIApplication.sharedApplication.applicationIconBadgeNumber > unreadNotificationCount) {
         if ([UAirship isFlying]) {
@@ -224,9 +224,9 @@ enum ApplicationSignal {
         static func hasUserUnreadNotifications() -> AnyPublisher<Bool, Never> {
             NotificationCenter.default.weakPublisher(for: .UserNotificationsDidChange)
                 .map { _ in
-                    !UserNotification.unreadNotifications.isEmpty
+                    UserNotification.unreadNotificationCount != 0
                 }
-                .prepend(!UserNotification.unreadNotifications.isEmpty)
+                .prepend(UserNotification.unreadNotificationCount != 0)
                 .eraseToAnyPublisher()
         }
     #endif
@@ -277,53 +277,40 @@ private enum UserInteractionUpdateKey {
 // MARK: Signals for immediate data updates resulting from user interaction
 
 enum UserInteractionSignal {
-    private static func consolidate(items: [Content.Item], with notification: Notification) -> [Content.Item] {
-        if let addedItems = notification.userInfo?[UserInteractionUpdateKey.removedItems] as? [Content.Item] {
-            Array(Set(items).union(addedItems))
-        } else if let removedItems = notification.userInfo?[UserInteractionUpdateKey.addedItems] as? [Content.Item] {
-            Array(Set(items).subtracting(removedItems))
-        } else {
-            items
-        }
+    private static func changeSets(for name: Notification.Name) -> AnyPublisher<ItemChangeSet<Content.Item>, Never> {
+        NotificationCenter.default.weakPublisher(for: name)
+            .scan(ItemChangeSet<Content.Item>(version: 0, insertedItems: [], removedItems: [])) { changeSet, notification in
+                ItemChangeSet(
+                    version: changeSet.version + 1,
+                    insertedItems: notification.userInfo?[UserInteractionUpdateKey.addedItems] as? [Content.Item] ?? [],
+                    removedItems: notification.userInfo?[UserInteractionUpdateKey.removedItems] as? [Content.Item] ?? []
+                )
+            }
+            .eraseToAnyPublisher()
     }
 
     #if os(iOS)
-        static func downloadUpdates() -> AnyPublisher<[Content.Item], Never> {
-            NotificationCenter.default.weakPublisher(for: .didUpdateDownloads)
-                .scan([Content.Item]()) { consolidate(items: $0, with: $1) }
-                .removeDuplicates()
-                .eraseToAnyPublisher()
+        static func downloadUpdates() -> AnyPublisher<ItemChangeSet<Content.Item>, Never> {
+            changeSets(for: .didUpdateDownloads)
         }
     #endif
 
-    static func favoriteUpdates() -> AnyPublisher<[Content.Item], Never> {
-        NotificationCenter.default.weakPublisher(for: .didUpdateFavorites)
-            .scan([Content.Item]()) { consolidate(items: $0, with: $1) }
-            .removeDuplicates()
-            .eraseToAnyPublisher()
+    static func favoriteUpdates() -> AnyPublisher<ItemChangeSet<Content.Item>, Never> {
+        changeSets(for: .didUpdateFavorites)
     }
 
-    static func historyUpdates() -> AnyPublisher<[Content.Item], Never> {
-        NotificationCenter.default.weakPublisher(for: .didUpdateHistoryEntries)
-            .scan([Content.Item]()) { consolidate(items: $0, with: $1) }
-            .removeDuplicates()
-            .eraseToAnyPublisher()
+    static func historyUpdates() -> AnyPublisher<ItemChangeSet<Content.Item>, Never> {
+        changeSets(for: .didUpdateHistoryEntries)
     }
 
     #if os(iOS)
-        static func notificationUpdates() -> AnyPublisher<[Content.Item], Never> {
-            NotificationCenter.default.weakPublisher(for: .didUpdateNotifications)
-                .scan([Content.Item]()) { consolidate(items: $0, with: $1) }
-                .removeDuplicates()
-                .eraseToAnyPublisher()
+        static func notificationUpdates() -> AnyPublisher<ItemChangeSet<Content.Item>, Never> {
+            changeSets(for: .didUpdateNotifications)
         }
     #endif
 
-    static func watchLaterUpdates() -> AnyPublisher<[Content.Item], Never> {
-        NotificationCenter.default.weakPublisher(for: .didUpdateWatchLaterEntries)
-            .scan([Content.Item]()) { consolidate(items: $0, with: $1) }
-            .removeDuplicates()
-            .eraseToAnyPublisher()
+    static func watchLaterUpdates() -> AnyPublisher<ItemChangeSet<Content.Item>, Never> {
+        changeSets(for: .didUpdateWatchLaterEntries)
     }
 }
 
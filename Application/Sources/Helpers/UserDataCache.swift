@@ -0,0 +1,362 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+import AVFoundation
+import Combine
+import SRGUserData
+
+/**
+ *  In-memory cache of the history and watch later states of medias currently displayed. Lookups requested during
+ *  the same run loop turn are batched into a single fetch per store. The cache is kept up-to-date using the uids
+ *  reported by user data change notifications, so that values can be read synchronously from memory. Playback positions
+ *  recorded during playback but not saved to the history yet are applied as well.
+ *
+ *  The cache also maintains the set of uids contained in the history and in the watch later playlist, loaded once
+ *  when first needed and then updated incrementally, so that entry counts are available without full fetches. These
+ *  counts are displayed in settings. The profile tab badge is unrelated, as it displays unread notifications.
+ *
+ *  Must be used from the main thread.
+ */
+final class UserDataCache {
+    static let shared = UserDataCache()
+
+    private enum Store {
+        case history
+        case watchLater
+    }
+
+    private var playbackPositions = [String: TimeInterval?]()
+    private var watchLaterStates = [String: Bool]()
+    private var interests = [String: Int]()
+
+    private var pendingHistoryUrns = Set<String>()
+    private var pendingWatchLaterUrns = Set<String>()
+    private var isFlushScheduled = false
+
+    private var historyUids: Set<String>?
+    private var watchLaterUids: Set<String>?
+    private var loadingStores = Set<Store>()
+    private var outdatedStores = Set<Store>()
+
+    private let historyChanges = PassthroughSubject<Set<String>, Never>()
+    private let watchLaterChanges = PassthroughSubject<Set<String>, Never>()
+    private let historyEntryCount = CurrentValueSubject<Int?, Never>(nil)
+    private let watchLaterEntryCount = CurrentValueSubject<Int?, Never>(nil)
+    private var cancellables = Set<AnyCancellable>()
+
+    private init() {
+        NotificationCenter.default.weakPublisher(for: .SRGHistoryEntriesDidChange, object: SRGUserData.current?.history)
+            .receive(on: DispatchQueue.main)
+            .sink { [weak self] notification in
+                let uids = notification.userInfo?[SRGHistoryEntriesUidsKey] as? Set<String>
+                self?.invalidate(.history, uids: uids)
+            }
+            .store(in: &cancellables)
+        NotificationCenter.default.weakPublisher(for: .SRGPlaylistEntriesDidChange, object: SRGUserData.current?.playlists)
+            .filter { notification in
+                guard let playlistUid = notification.userInfo?[SRGPlaylistUidKey] as? String else { return false }
+                return playlistUid == SRGPlaylistUid.watchLater.rawValue
+            }
+            .receive(on: DispatchQueue.main)
+            .sink { [weak self] notification in
+                let uids = notification.userInfo?[SRGPlaylistEntriesUidsKey] as? Set<String>
+                self?.invalidate(.watchLater, uids: uids)
+            }
+            .store(in: &cancellables)
+        NotificationCenter.default.weakPublisher(for: .HistoryPendingPlaybackPositionsDidChange)
+            .sink { [weak self] notification in
+                guard let uids = notification.userInfo?[HistoryPendingPlaybackUidsKey] as? Set<String> else { return }
+                self?.updatePendingPlaybackPositions(for: uids)
+            }
+            .store(in: &cancellables)
+    }
+
+    /**
+     *  Publishes the playback progress of a media, `nil` until known or if the media has not been played yet.
+     */
+    func playbackProgressPublisher(for media: SRGMedia, interval: TimeInterval = 10) -> AnyPublisher<Double?, Never> {
+        guard HistoryIsProgressForMediaTracked(media) else {
+            return Just(nil).eraseToAnyPublisher()
+        }
+        return publisher(for: media.urn, in: .history, changes: historyChanges, interval: interval) { [weak self] in
+            self?.playbackProgress(for: media)
+        }
+    }
+
+    /**
+     *  Publishes the allowed watch later action for a media, `.none` until known.
+     */
+    func laterAllowedActionPublisher(for media: SRGMedia, interval: TimeInterval = 10) -> AnyPublisher<WatchLaterAction, Never> {
+        publisher(for: media.urn, in: .watchLater, changes: watchLaterChanges, interval: interval) { [weak self] in
+            self?.laterAllowedAction(for: media) ?? WatchLaterAction.none
+        }
+    }
+
+    /**
+     *  Publishes the number of entries in the history.
+     */
+    func historyEntryCountPublisher() -> AnyPublisher<Int, Never> {
+        entryCountPublisher(for: .history, subject: historyEntryCount)
+    }
+
+    /**
+     *  Publishes the number of entries in the watch later playlist.
+     */
+    func watchLaterEntryCountPublisher() -> AnyPublisher<Int, Never> {
+        entryCountPublisher(for: .watchLater, subject: watchLaterEntryCount)
+    }
+
+    /**
+     *  Publishes the number of favorite shows.
+     */
+    func favoriteCountPublisher() -> AnyPublisher<Int, Never> {
+        ThrottledSignal.preferenceUpdates(interval: 0)
+            .prepend(())
+            .map { FavoritesShowURNs().count }
+            .removeDuplicates()
+            .eraseToAnyPublisher()
+    }
+
+    /**
+     *  The cached playback progress of a media, `nil` if unknown or if the media has not been played yet.
+     */
+    func playbackProgress(for media: SRGMedia) -> Double? {
+        guard HistoryIsProgressForMediaTracked(media), let playbackPosition = playbackPositions[media.urn] ?? nil else { return nil }
+        let progress = Double(HistoryPlaybackProgress(playbackPosition, media.duration / 1000))
+        return progress != 0 ? progress : nil
+    }
+
+    /**
+     *  The cached allowed watch later action for a media, `nil` if unknown.
+     */
+    func laterAllowedAction(for media: SRGMedia) -> WatchLaterAction? {
+        guard let contained = watchLaterStates[media.urn] else { return nil }
+        if contained {
+            return .remove
+        } else if media.contentType != .livestream, media.timeAvailability(at: Date()) != .notAvailableAnymore {
+            return .add
+        } else {
+            return WatchLaterAction.none
+        }
+    }
+
+    private func publisher<T>(for urn: String, in store: Store, changes: PassthroughSubject<Set<String>, Never>, interval: TimeInterval, value: @escaping () -> T) -> AnyPublisher<T, Never> {
+        Deferred {
+            changes
+                .filter { $0.contains(urn) }
+                .throttle(for: .seconds(interval), scheduler: DispatchQueue.main, latest: true)
+                .map { _ in }
+                .prepend(())
+                .map { _ in value() }
+                .handleEvents(receiveSubscription: { [weak self] _ in
+                    self?.retain(urn, in: store)
+                }, receiveCancel: { [weak self] in
+                    self?.release(urn)
+                })
+        }
+        .subscribe(on: DispatchQueue.main)
+        .eraseToAnyPublisher()
+    }
+
+    private func entryCountPublisher(for store: Store, subject: CurrentValueSubject<Int?, Never>) -> AnyPublisher<Int, Never> {
+        Deferred {
+            self.loadUidsIfNeeded(in: store)
+            return subject
+                .compactMap { $0 }
+                .removeDuplicates()
+        }
+        .subscribe(on: DispatchQueue.main)
+        .eraseToAnyPublisher()
+    }
+
+    private func uids(in store: Store) -> Set<String>? {
+        switch store {
+        case .history:
+            historyUids
+        case .watchLater:
+            watchLaterUids
+        }
+    }
+
+    private func setUids(_ uids: Set<String>, in store: Store) {
+        switch store {
+        case .history:
+            historyUids = uids
+            historyEntryCount.send(uids.count)
+        case .watchLater:
+            watchLaterUids = uids
+            watchLaterEntryCount.send(uids.count)
+        }
+    }
+
+    private func loadUidsIfNeeded(in store: Store) {
+        guard uids(in: store) == nil else { return }
+        loadUids(in: store)
+    }
+
+    private func loadUids(in store: Store) {
+        guard let userData = SRGUserData.current, !loadingStores.contains(store) else { return }
+        loadingStores.insert(store)
+        outdatedStores.remove(store)
+
+        func completion(_ uids: Set<String>?) {
+            DispatchQueue.main.async {
+                self.loadingStores.remove(store)
+                if let uids {
+                    self.setUids(uids, in: store)
+                }
+                if self.outdatedStores.contains(store) {
+                    self.loadUids(in: store)
+                }
+            }
+        }
+
+        switch store {
+        case .history:
+            userData.history.historyEntries(matching: nil, sortedWith: nil) { historyEntries, error in
+                completion(error == nil ? Set((historyEntries ?? []).compactMap(\.uid)) : nil)
+            }
+        case .watchLater:
+            userData.playlists.playlistEntriesInPlaylist(withUid: SRGPlaylistUid.watchLater.rawValue, matching: nil, sortedWith: nil) { playlistEntries, error in
+                completion(error == nil ? Set((playlistEntries ?? []).compactMap(\.uid)) : nil)
+            }
+        }
+    }
+
+    private func retain(_ urn: String, in store: Store) {
+        interests[urn, default: 0] += 1
+
+        switch store {
+        case .history:
+            if playbackPositions[urn] == nil {
+                pendingHistoryUrns.insert(urn)
+            }
+        case .watchLater:
+            if watchLaterStates[urn] == nil {
+                pendingWatchLaterUrns.insert(urn)
+            }
+        }
+        scheduleFlush()
+    }
+
+    private func release(_ urn: String) {
+        // Cancellation can occur on any thread
+        DispatchQueue.main.async {
+            guard let count = self.interests[urn] else { return }
+            if count > 1 {
+                self.interests[urn] = count - 1
+            } else {
+                self.interests[urn] = nil
+                self.playbackPositions[urn] = nil
+                self.watchLaterStates[urn] = nil
+                self.pendingHistoryUrns.remove(urn)
+                self.pendingWatchLaterUrns.remove(urn)
+            }
+        }
+    }
+
+    private func invalidate(_ store: Store, uids: Set<String>?) {
+        // Entry uids are updated by checking the existence of changed uids, or entirely reloaded if changes are unknown
+        if loadingStores.contains(store) {
+            outdatedStores.insert(store)
+        } else if self.uids(in: store) != nil, uids == nil {
+            loadUids(in: store)
+        }
+        let indexedUids = self.uids(in: store) != nil ? uids ?? [] : []
+
+        switch store {
+        case .history:
+            let urns = uids?.filter { playbackPositions[$0] != nil } ?? Set(playbackPositions.keys)
+            pendingHistoryUrns.formUnion(urns.union(indexedUids))
+        case .watchLater:
+            let urns = uids?.filter { watchLaterStates[$0] != nil } ?? Set(watchLaterStates.keys)
+            pendingWatchLaterUrns.formUnion(urns.union(indexedUids))
+        }
+        scheduleFlush()
+    }
+
+    private func scheduleFlush() {
+        guard !isFlushScheduled, !pendingHistoryUrns.isEmpty || !pendingWatchLaterUrns.isEmpty else { return }
+        isFlushScheduled = true
+
+        // Wait for the end of the current run loop turn so that lookups from all cells being displayed are batched
+        DispatchQueue.main.async {
+            self.isFlushScheduled = false
+            self.flush()
+        }
+    }
+
+    private func flush() {
+        guard let userData = SRGUserData.current else { return }
+
+        if !pendingHistoryUrns.isEmpty {
+            let urns = pendingHistoryUrns
+            pendingHistoryUrns.removeAll()
+
+            let predicate = NSPredicate(format: "%K IN %@", #keyPath(SRGHistoryEntry.uid), urns)
+            userData.history.historyEntries(matching: predicate, sortedWith: nil) { historyEntries, error in
+                guard error == nil else { return }
+                let positions = Dictionary((historyEntries ?? []).compactMap { historyEntry in
+                    historyEntry.uid.map { ($0, CMTimeGetSeconds(historyEntry.lastPlaybackTime)) }
+                }, uniquingKeysWith: { first, _ in first })
+                DispatchQueue.main.async {
+                    self.updatePlaybackPositions(positions, for: urns)
+                }
+            }
+        }
+
+        if !pendingWatchLaterUrns.isEmpty {
+            let urns = pendingWatchLaterUrns
+            pendingWatchLaterUrns.removeAll()
+
+            let predicate = NSPredicate(format: "%K IN %@", #keyPath(SRGPlaylistEntry.uid), urns)
+            userData.playlists.playlistEntriesInPlaylist(withUid: SRGPlaylistUid.watchLater.rawValue, matching: predicate, sortedWith: nil) { playlistEntries, error in
+                guard error == nil else { return }
+                let containedUrns = Set((playlistEntries ?? []).compactMap(\.uid))
+                DispatchQueue.main.async {
+                    self.updateWatchLaterStates(containedUrns, for: urns)
+                }
+            }
+        }
+    }
+
+    private func updatePendingPlaybackPositions(for uids: Set<String>) {
+        let urns = uids.filter { interests[$0] != nil }
+        for urn in urns {
+            guard let pendingPlaybackTime = HistoryPendingPlaybackTime(urn) else { continue }
+            playbackPositions[urn] = .some(CMTimeGetSeconds(pendingPlaybackTime.timeValue))
+        }
+        historyChanges.send(urns)
+    }
+
+    private func updatePlaybackPositions(_ positions: [String: TimeInterval], for urns: Set<String>) {
+        if var historyUids {
+            historyUids.subtract(urns)
+            historyUids.formUnion(positions.keys)
+            setUids(historyUids, in: .history)
+        }
+
+        let urns = urns.filter { interests[$0] != nil }
+        for urn in urns {
+            playbackPositions[urn] = .some(positions[urn])
+        }
+        historyChanges.send(urns)
+    }
+
+    private func updateWatchLaterStates(_ containedUrns: Set<String>, for urns: Set<String>) {
+        if var watchLaterUids {
+            watchLaterUids.subtract(urns)
+            watchLaterUids.formUnion(containedUrns)
+            setUids(watchLaterUids, in: .watchLater)
+        }
+
+        let urns = urns.filter { interests[$0] != nil }
+        for urn in urns {
+            watchLaterStates[urn] = containedUrns.contains(urn)
+        }
+        watchLaterChanges.send(urns)
+    }
+}
@@ -0,0 +1,151 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+import Combine
+import UIKit
+
+/**
+ *  Shared clock driving all periodic date updates with a single timer. Ticks are aligned on period boundaries so
+ *  that subscribers with the same period are woken up together. Subscribers can provide an additional boundary
+ *  date (e.g. the end of a program) at which they want to be notified as well.
+ *
+ *  Like `ForegroundTimer`, the clock is paused while the application is in background. Overdue subscribers are
+ *  notified when the application returns to the foreground.
+ *
+ *  Must be used from the main thread.
+ */
+final class WallClock {
+    static let shared = WallClock()
+
+    private struct Subscription {
+        let period: TimeInterval
+        let boundary: (() -> Date?)?
+        let subject: PassthroughSubject<Date, Never>
+        var nextDate: Date
+    }
+
+    private var subscriptions = [UUID: Subscription]()
+    private var timer: Timer?
+    private var isSuspended = UIApplication.shared.applicationState == .background
+    private var wakeupDates = [Date]()
+    private var lastStatisticsLogDate = Date()
+    private var cancellables = Set<AnyCancellable>()
+
+    /// The number of subscribers which would otherwise each require their own timer.
+    var numberOfSubscribers: Int {
+        subscriptions.count
+    }
+
+    /// The number of timers currently scheduled by the clock (at most one).
+    var numberOfLiveTimers: Int {
+        timer != nil ? 1 : 0
+    }
+
+    /// The number of wakeups during the last minute.
+    var wakeupsPerMinute: Int {
+        let minuteAgo = Date().addingTimeInterval(-60)
+        return wakeupDates.filter { $0 > minuteAgo }.count
+    }
+
+    private init() {
+        ApplicationSignal.background()
+            .sink { [weak self] in
+                self?.suspend()
+            }
+            .store(in: &cancellables)
+        ApplicationSignal.foreground()
+            .sink { [weak self] in
+                self?.resume()
+            }
+            .store(in: &cancellables)
+    }
+
+    /**
+     *  Publishes the current date every `period`, aligned on period boundaries, as well as at the date returned by
+     *  `boundary` (evaluated after each tick), if any.
+     */
+    func publisher(every period: TimeInterval, boundary: (() -> Date?)? = nil) -> AnyPublisher<Date, Never> {
+        Deferred {
+            let id = UUID()
+            let subject = PassthroughSubject<Date, Never>()
+            self.subscribe(id: id, subscription: Subscription(period: period, boundary: boundary, subject: subject, nextDate: Self.nextDate(after: Date(), period: period, boundary: boundary)))
+            return subject
+                .handleEvents(receiveCancel: {
+                    self.unsubscribe(id: id)
+                })
+        }
+        .eraseToAnyPublisher()
+    }
+
+    private static func nextDate(after date: Date, period: TimeInterval, boundary: (() -> Date?)?) -> Date {
+        let alignedDate = Date(timeIntervalSinceReferenceDate: (floor(date.timeIntervalSinceReferenceDate / period) + 1) * period)
+        if let boundaryDate = boundary?(), boundaryDate > date, boundaryDate < alignedDate {
+            return boundaryDate
+        } else {
+            return alignedDate
+        }
+    }
+
+    private func subscribe(id: UUID, subscription: Subscription) {
+        subscriptions[id] = subscription
+        scheduleTimer()
+    }
+
+    private func unsubscribe(id: UUID) {
+        subscriptions[id] = nil
+        scheduleTimer()
+    }
+
+    private func scheduleTimer() {
+        guard !isSuspended, let fireDate = subscriptions.values.map(\.nextDate).min() else {
+            timer?.invalidate()
+            timer = nil
+            return
+        }
+        guard timer?.fireDate != fireDate else { return }
+
+        timer?.invalidate()
+        let timer = Timer(fire: fireDate, interval: 0, repeats: false) { [weak self] _ in
+            self?.tick()
+        }
+        timer.tolerance = 0.1
+        RunLoop.main.add(timer, forMode: .common)
+        self.timer = timer
+    }
+
+    private func tick() {
+        timer = nil
+
+        let date = Date()
+        wakeupDates.append(date)
+        wakeupDates.removeAll { $0 < date.addingTimeInterval(-60) }
+        logStatisticsIfNeeded(at: date)
+
+        // Accept a small tolerance so that ticks slightly in advance are not missed
+        let dueDate = date.addingTimeInterval(0.1)
+        for (id, subscription) in subscriptions where subscription.nextDate <= dueDate {
+            subscriptions[id]?.nextDate = Self.nextDate(after: dueDate, period: subscription.period, boundary: subscription.boundary)
+            subscription.subject.send(date)
+        }
+        scheduleTimer()
+    }
+
+    private func suspend() {
+        isSuspended = true
+        scheduleTimer()
+    }
+
+    private func resume() {
+        isSuspended = false
+        tick()
+    }
+
+    private func logStatisticsIfNeeded(at date: Date) {
+        guard date.timeIntervalSince(lastStatisticsLogDate) >= 60 else { return }
+        lastStatisticsLogDate = date
+        PlayLogDebug(category: "wallclock", message: "\(numberOfSubscribers) subscribers, \(numberOfLiveTimers) live timers, \(wakeupsPerMinute) wakeups per minute")
+    }
+}
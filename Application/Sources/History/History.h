@@ -11,15 +11,38 @@
 NS_ASSUME_NONNULL_BEGIN
 
 /**
- *  Update playback progress based on the provided controller.
+ *  Notification sent on the main thread when playback positions not saved to the history yet are recorded. Use the
+ *  `HistoryPendingPlaybackUidsKey` to retrieve the uids of the corresponding entries (as a set) from the notification
+ *  `userInfo` dictionary.
+ */
+OBJC_EXPORT NSString * const HistoryPendingPlaybackPositionsDidChangeNotification;
+OBJC_EXPORT NSString * const HistoryPendingPlaybackUidsKey;
+
+/**
+ *  Update playback progress based on the provided controller. Positions are kept in memory and saved to the history
+ *  on pause, seek, chapter or segment change, when the application enters the background, or at regular intervals.
  */
 OBJC_EXPORT void HistoryUpdateLetterboxPlaybackProgress(SRGLetterboxController *letterboxController);
 
+/**
+ *  Return the latest playback position recorded for the specified entry uid, if not saved to the history yet.
+ *
+ *  @discussion Can be called on any thread.
+ */
+OBJC_EXPORT NSValue * _Nullable HistoryPendingPlaybackTime(NSString * _Nullable uid);
+
 /**
  *  Return `YES` iff the history contains an entry for the specified media.
  */
 OBJC_EXPORT BOOL HistoryContainsMedia(SRGMedia *media);
 
+/**
+ *  Return `YES` iff playback progress is tracked in the history for the specified media.
+ *
+ *  @discussion Can be called on any thread.
+ */
+OBJC_EXPORT BOOL HistoryIsProgressForMediaTracked(SRGMedia * _Nullable media);
+
 /**
  *  Return the playback progress corresponding to the specified playback position and media duration. This takes
  *  into account end tolerance settings which might be applied.
@@ -73,6 +96,14 @@ OBJC_EXPORT NSString * _Nullable HistoryCanResumePlaybackForMediaAsync(SRGMedia
  */
 OBJC_EXPORT void HistoryRemoveMedias(NSArray<SRGMedia *> *medias, void (^completion)(NSError * _Nullable error));
 
+/**
+ *  Statistics about history writes and change notifications, normalized per hour of playback.
+ *
+ *  @discussion Must be called from the main thread.
+ */
+OBJC_EXPORT double HistoryWritesPerPlaybackHour(void);
+OBJC_EXPORT double HistoryNotificationsPerPlaybackHour(void);
+
 /**
  *  Cancel a progress async request.
  */
@@ -11,6 +11,7 @@
 #import "Download.h"
 #endif
 #import "NSTimer+PlaySRG.h"
+#import "PlayLogger.h"
 #import "PlaySRG-Swift.h"
 
 @import libextobjc;
@@ -20,12 +21,31 @@
 #endif
 @import SRGUserData;
 
+NSString * const HistoryPendingPlaybackPositionsDidChangeNotification = @"HistoryPendingPlaybackPositionsDidChangeNotification";
+NSString * const HistoryPendingPlaybackUidsKey = @"HistoryPendingPlaybackUids";
+
+// Playback positions are kept in memory and written to the history on meaningful events only (pause, seek, chapter or segment
+// change, backgrounding) or at regular intervals. Positions are written in the order they were recorded.
+static const NSTimeInterval kHistoryFlushInterval = 30.;
+
 static NSMutableDictionary<NSString *, NSNumber *> *s_cachedProgresses;
+static NSMutableDictionary<NSString *, NSValue *> *s_pendingPlaybackTimes;
+static NSMutableArray<NSString *> *s_pendingUids;
+static NSArray<NSString *> *s_trackedUids;
+static NSString *s_pendingDeviceUid;
+static NSDate *s_lastFlushDate;
+static BOOL s_flushNeeded;
+
+static NSUInteger s_numberOfWrites;
+static NSUInteger s_numberOfNotifications;
+static NSTimeInterval s_playbackDuration;
+static NSDate *s_lastPlaybackUpdateDate;
+
 #if TARGET_OS_IOS
 static NSTimer *s_trackerTimer;
 #endif
 
-static BOOL HistoryIsProgressForMediaTracked(SRGMedia *media);
+static float HistoryPlaybackProgressForMediaPlaybackTime(CMTime playbackTime, SRGMedia *media);
 static float HistoryPlaybackProgressForMediaHistoryEntry(SRGHistoryEntry *historyEntry, SRGMedia *media);
 
 #pragma mark Helpers
@@ -54,18 +74,21 @@ SRGPosition *HistoryResumePlaybackPositionForMedia(SRGMedia *media)
     }
     
     SRGHistoryEntry *historyEntry = [SRGUserData.currentUserData.history historyEntryWithUid:media.URN];
-    if (! historyEntry) {
+    NSValue *pendingPlaybackTime = HistoryPendingPlaybackTime(media.URN);
+    if (! historyEntry && ! pendingPlaybackTime) {
         return nil;
     }
     
+    CMTime playbackTime = pendingPlaybackTime ? pendingPlaybackTime.CMTimeValue : historyEntry.lastPlaybackTime;
+    
     // Start at the default location if the content was played entirely.
-    if (HistoryPlaybackProgressForMediaHistoryEntry(historyEntry, media) == 1.f) {
+    if (HistoryPlaybackProgressForMediaPlaybackTime(playbackTime, media) == 1.f) {
         return nil;
     }
     
     // TODO: Fix stream issues (see https://github.com/SRGSSR/srgletterbox-apple/issues/245) then restore `positionBeforeTime:`
     //       which was the initially desired behavior.
-    return [SRGPosition positionAtTime:historyEntry.lastPlaybackTime];
+    return [SRGPosition positionAtTime:playbackTime];
 }
 
 NSString *HistoryResumePlaybackPositionForMediaAsync(SRGMedia *media, void (^completion)(SRGPosition * _Nullable position))
@@ -76,15 +99,18 @@ NSString *HistoryResumePlaybackPositionForMediaAsync(SRGMedia *media, void (^com
     }
     
     return [SRGUserData.currentUserData.history historyEntryWithUid:media.URN completionBlock:^(SRGHistoryEntry * _Nullable historyEntry, NSError * _Nullable error) {
+        NSValue *pendingPlaybackTime = HistoryPendingPlaybackTime(media.URN);
+        CMTime playbackTime = pendingPlaybackTime ? pendingPlaybackTime.CMTimeValue : historyEntry.lastPlaybackTime;
+        
         // Start at the default location if the content was played entirely.
-        if (HistoryPlaybackProgressForMediaHistoryEntry(historyEntry, media) == 1.f) {
+        if (HistoryPlaybackProgressForMediaPlaybackTime(playbackTime, media) == 1.f) {
             completion(nil);
             return;
         }
         
         // TODO: Fix stream issues (see https://github.com/SRGSSR/srgletterbox-apple/issues/245) then restore `positionBeforeTime:`
         //       which was the initially desired behavior.
-        SRGPosition *position = [SRGPosition positionAtTime:historyEntry.lastPlaybackTime];
+        SRGPosition *position = [SRGPosition positionAtTime:playbackTime];
         completion(position);
     }];
 }
@@ -142,6 +168,105 @@ static SRGMedia *HistoryChapterMedia(SRGLetterboxController *controller)
     return nil;
 }
 
+#pragma mark Position journal
+
+NSValue *HistoryPendingPlaybackTime(NSString *uid)
+{
+    if (! uid) {
+        return nil;
+    }
+    
+    @synchronized (s_pendingPlaybackTimes) {
+        return s_pendingPlaybackTimes[uid];
+    }
+}
+
+/**
+ *  Write pending playback positions to the history. Must be called from the main thread.
+ */
+static void HistoryFlushPlaybackPositions(void)
+{
+    s_lastFlushDate = NSDate.date;
+    s_flushNeeded = NO;
+    
+    NSArray<NSString *> *pendingUids = s_pendingUids.copy;
+    [s_pendingUids removeAllObjects];
+    
+    NSDictionary<NSString *, NSValue *> *pendingPlaybackTimes = nil;
+    @synchronized (s_pendingPlaybackTimes) {
+        pendingPlaybackTimes = s_pendingPlaybackTimes.copy;
+        [s_pendingPlaybackTimes removeAllObjects];
+    }
+    
+    for (NSString *uid in pendingUids) {
+        CMTime playbackTime = pendingPlaybackTimes[uid].CMTimeValue;
+        [SRGUserData.currentUserData.history saveHistoryEntryWithUid:uid lastPlaybackTime:playbackTime deviceUid:s_pendingDeviceUid completionBlock:nil];
+        s_numberOfWrites++;
+    }
+    
+    if (pendingUids.count != 0) {
+        PlayLogDebug(@"history", @"Saved %@ playback positions. %.0f writes and %.0f notifications per playback hour",
+                     @(pendingUids.count), HistoryWritesPerPlaybackHour(), HistoryNotificationsPerPlaybackHour());
+    }
+}
+
+/**
+ *  Record playback positions in memory, in the order in which they must be saved. Must be called from the main thread.
+ */
+static void HistoryRecordPlaybackTimes(NSArray<NSString *> *uids, NSArray<NSValue *> *playbackTimes, NSString *deviceUid)
+{
+    NSDate *date = NSDate.date;
+    if (s_lastPlaybackUpdateDate) {
+        // Ignore gaps (e.g. while paused) so that only playback time is accounted for
+        s_playbackDuration += fmin([date timeIntervalSinceDate:s_lastPlaybackUpdateDate], 2.);
+    }
+    s_lastPlaybackUpdateDate = date;
+    
+    // Chapter or segment change. Save positions of the previously played items first.
+    if (! [uids isEqualToArray:s_trackedUids] || ! [deviceUid isEqualToString:s_pendingDeviceUid]) {
+        HistoryFlushPlaybackPositions();
+        s_trackedUids = uids.copy;
+        s_flushNeeded = YES;
+    }
+    
+    @synchronized (s_pendingPlaybackTimes) {
+        [uids enumerateObjectsUsingBlock:^(NSString * _Nonnull uid, NSUInteger idx, BOOL * _Nonnull stop) {
+            s_pendingPlaybackTimes[uid] = playbackTimes[idx];
+        }];
+    }
+    [s_pendingUids setArray:uids];
+    s_pendingDeviceUid = deviceUid;
+    
+    [NSNotificationCenter.defaultCenter postNotificationName:HistoryPendingPlaybackPositionsDidChangeNotification
+                                                      object:nil
+                                                    userInfo:@{ HistoryPendingPlaybackUidsKey : [NSSet setWithArray:uids] }];
+    
+    if (s_flushNeeded || [date timeIntervalSinceDate:s_lastFlushDate] >= kHistoryFlushInterval) {
+        HistoryFlushPlaybackPositions();
+    }
+}
+
+/**
+ *  Save pending positions when playback is not running anymore. Must be called from the main thread.
+ */
+static void HistoryPlaybackDidStop(void)
+{
+    s_lastPlaybackUpdateDate = nil;
+    if (s_pendingUids.count != 0) {
+        HistoryFlushPlaybackPositions();
+    }
+}
+
+double HistoryWritesPerPlaybackHour(void)
+{
+    return (s_playbackDuration > 0.) ? s_numberOfWrites * 3600. / s_playbackDuration : 0.;
+}
+
+double HistoryNotificationsPerPlaybackHour(void)
+{
+    return (s_playbackDuration > 0.) ? s_numberOfNotifications * 3600. / s_playbackDuration : 0.;
+}
+
 #pragma mark Player tracker
 
 /**
@@ -150,11 +275,13 @@ static SRGMedia *HistoryChapterMedia(SRGLetterboxController *controller)
 void HistoryUpdateLetterboxPlaybackProgress(SRGLetterboxController *letterboxController)
 {
     if (letterboxController.playbackState != SRGMediaPlayerPlaybackStatePlaying) {
+        HistoryPlaybackDidStop();
         return;
     }
     
     SRGMedia *chapterMedia = HistoryChapterMedia(letterboxController);
     if (! chapterMedia || chapterMedia.contentType == SRGContentTypeLivestream) {
+        HistoryPlaybackDidStop();
         return;
     }
     
@@ -162,17 +289,24 @@ void HistoryUpdateLetterboxPlaybackProgress(SRGLetterboxController *letterboxCon
     CMTime chapterPlaybackTime = (chapterMedia.contentType != SRGContentTypeScheduledLivestream && CMTIME_IS_VALID(currentTime)) ? currentTime : kCMTimeZero;
     NSString *deviceUid = UIDevice.currentDevice.name;
     
-    // Save the segment position.
+    NSMutableArray<NSString *> *uids = [NSMutableArray array];
+    NSMutableArray<NSValue *> *playbackTimes = [NSMutableArray array];
+    
+    // Record the segment position.
     SRGSubdivision *subdivision = letterboxController.subdivision;
     if ([subdivision isKindOfClass:SRGSegment.class]) {
         SRGSegment *segment = (SRGSegment *)subdivision;
         CMTime segmentPlaybackTime = CMTimeMaximum(CMTimeSubtract(chapterPlaybackTime, CMTimeMakeWithSeconds(segment.markIn / 1000., NSEC_PER_SEC)), kCMTimeZero);
-        [SRGUserData.currentUserData.history saveHistoryEntryWithUid:segment.URN lastPlaybackTime:segmentPlaybackTime deviceUid:deviceUid completionBlock:nil];
+        [uids addObject:segment.URN];
+        [playbackTimes addObject:[NSValue valueWithCMTime:segmentPlaybackTime]];
     }
     
-    // Save the main full-length position (update after the segment so that full-length entries are always more recent than corresponding
+    // Record the main full-length position (saved after the segment so that full-length entries are always more recent than corresponding
     // segment entries)
-    [SRGUserData.currentUserData.history saveHistoryEntryWithUid:chapterMedia.URN lastPlaybackTime:chapterPlaybackTime deviceUid:deviceUid completionBlock:nil];
+    [uids addObject:chapterMedia.URN];
+    [playbackTimes addObject:[NSValue valueWithCMTime:chapterPlaybackTime]];
+    
+    HistoryRecordPlaybackTimes(uids.copy, playbackTimes.copy, deviceUid);
     
     // TODO: For a perfect result we should also call -[UserInteractionEvent addToHistory:]` for the chapter (and segment, if any) here,
     //       to ensure correct behavior in the following case:
@@ -199,17 +333,20 @@ static BOOL HistoryUpdateGoogleCastPlaybackProgress(void)
     GCKRemoteMediaClient *remoteMediaClient = session.remoteMediaClient;
     GCKMediaStatus *mediaStatus = remoteMediaClient.mediaStatus;
     if (mediaStatus.playerState != GCKMediaPlayerStatePlaying) {
+        HistoryPlaybackDidStop();
         return YES;
     }
     
     // Only for on-demand streams
     GCKMediaInformation *mediaInformation = mediaStatus.mediaInformation;
     if (mediaInformation.streamType != GCKMediaStreamTypeBuffered) {
+        HistoryPlaybackDidStop();
         return YES;
     }
     
     NSString *URN = mediaInformation.contentID;
     if (! URN) {
+        HistoryPlaybackDidStop();
         return YES;
     }
     
@@ -217,7 +354,7 @@ static BOOL HistoryUpdateGoogleCastPlaybackProgress(void)
     // interpolates between known values to get a smoother progress
     NSTimeInterval streamPosition = remoteMediaClient.approximateStreamPosition;
     NSString *deviceUid = UIDevice.currentDevice.name;
-    [SRGUserData.currentUserData.history saveHistoryEntryWithUid:URN lastPlaybackTime:CMTimeMakeWithSeconds(streamPosition, NSEC_PER_SEC) deviceUid:deviceUid completionBlock:nil];
+    HistoryRecordPlaybackTimes(@[URN], @[[NSValue valueWithCMTime:CMTimeMakeWithSeconds(streamPosition, NSEC_PER_SEC)]], deviceUid);
     
     return YES;
 }
@@ -227,6 +364,30 @@ static BOOL HistoryUpdateGoogleCastPlaybackProgress(void)
 __attribute__((constructor)) static void HistoryPlayerTrackerInit(void)
 {
     s_cachedProgresses = [NSMutableDictionary dictionary];
+    s_pendingPlaybackTimes = [NSMutableDictionary dictionary];
+    s_pendingUids = [NSMutableArray array];
+    s_lastFlushDate = NSDate.date;
+    
+    NSNotificationCenter *notificationCenter = NSNotificationCenter.defaultCenter;
+    [notificationCenter addObserverForName:SRGMediaPlayerPlaybackStateDidChangeNotification object:nil queue:NSOperationQueue.mainQueue usingBlock:^(NSNotification * _Nonnull notification) {
+        SRGMediaPlayerPlaybackState playbackState = [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue];
+        if (playbackState != SRGMediaPlayerPlaybackStatePlaying) {
+            HistoryPlaybackDidStop();
+        }
+    }];
+    [notificationCenter addObserverForName:SRGMediaPlayerSeekNotification object:nil queue:NSOperationQueue.mainQueue usingBlock:^(NSNotification * _Nonnull notification) {
+        // Save the position reached after the seek at the next update
+        s_flushNeeded = YES;
+    }];
+    [notificationCenter addObserverForName:UIApplicationDidEnterBackgroundNotification object:nil queue:NSOperationQueue.mainQueue usingBlock:^(NSNotification * _Nonnull notification) {
+        HistoryFlushPlaybackPositions();
+    }];
+    [notificationCenter addObserverForName:UIApplicationWillTerminateNotification object:nil queue:NSOperationQueue.mainQueue usingBlock:^(NSNotification * _Nonnull notification) {
+        HistoryFlushPlaybackPositions();
+    }];
+    [notificationCenter addObserverForName:SRGHistoryEntriesDidChangeNotification object:nil queue:NSOperationQueue.mainQueue usingBlock:^(NSNotification * _Nonnull notification) {
+        s_numberOfNotifications++;
+    }];
     
 #if TARGET_OS_IOS
     s_trackerTimer = [NSTimer play_timerWithTimeInterval:1. repeats:YES block:^(NSTimer * _Nonnull timer) {
@@ -242,20 +403,33 @@ __attribute__((constructor)) static void HistoryPlayerTrackerInit(void)
 
 #pragma mark Functions
 
-static BOOL HistoryIsProgressForMediaTracked(SRGMedia *media)
+BOOL HistoryIsProgressForMediaTracked(SRGMedia *media)
 {
     return media && media.duration > 0. && media.contentType != SRGContentTypeLivestream && media.contentType != SRGContentTypeScheduledLivestream;
 }
 
+static float HistoryPlaybackProgressForMediaPlaybackTime(CMTime playbackTime, SRGMedia *media)
+{
+    return HistoryPlaybackProgress(CMTimeGetSeconds(playbackTime), media.duration / 1000.);
+}
+
 static float HistoryPlaybackProgressForMediaHistoryEntry(SRGHistoryEntry *historyEntry, SRGMedia *media)
 {
     NSCParameterAssert(historyEntry);
-    return HistoryPlaybackProgress(CMTimeGetSeconds(historyEntry.lastPlaybackTime), media.duration / 1000.);
+    
+    // Prefer the latest position not saved yet, if any
+    NSValue *pendingPlaybackTime = HistoryPendingPlaybackTime(media.URN);
+    return HistoryPlaybackProgressForMediaPlaybackTime(pendingPlaybackTime ? pendingPlaybackTime.CMTimeValue : historyEntry.lastPlaybackTime, media);
 }
 
 float HistoryPlaybackProgressForMedia(SRGMedia *media)
 {
     if (HistoryIsProgressForMediaTracked(media)) {
+        NSValue *pendingPlaybackTime = HistoryPendingPlaybackTime(media.URN);
+        if (pendingPlaybackTime) {
+            return HistoryPlaybackProgressForMediaPlaybackTime(pendingPlaybackTime.CMTimeValue, media);
+        }
+        
         SRGHistoryEntry *historyEntry = [SRGUserData.currentUserData.history historyEntryWithUid:media.URN];
         return historyEntry ? HistoryPlaybackProgressForMediaHistoryEntry(historyEntry, media) : 0.f;
     }
@@ -120,7 +120,8 @@ typedef NS_ENUM(NSInteger, DownloadState) {
 @property (nonatomic, readonly, nullable) SRGMedia *media;
 
 /**
- *  The size of the downloaded file in bytes (0 if not downloaded)
+ *  The size of the downloaded files (media and image) in bytes (0 if the media was not downloaded). Tracked in memory,
+ *  must be accessed from the main thread.
  */
 @property (nonatomic, readonly) long long size;
 
@@ -133,6 +134,12 @@ typedef NS_ENUM(NSInteger, DownloadState) {
  */
 @property (class, nonatomic, readonly) NSArray<Download *> *downloads;
 
+/**
+ *  Maximum size in bytes of downloaded files. When exceeded, downloads which have been played entirely are removed,
+ *  least recently played first. Set to 0 (default) for no limit.
+ */
+@property (class, nonatomic) long long storageQuota;
+
 /**
  *  Return `YES` iff the download media status can be changed or displayed
  */
@@ -168,7 +175,8 @@ typedef NS_ENUM(NSInteger, DownloadState) {
 + (void)removeAllDownloads;
 
 /**
- *  Clean the downloaded folder to ununsed downloaded files
+ *  Clean the downloaded folder from unused downloaded files and apply the storage quota. Performed in the background
+ *  shortly afterwards, so that application startup is not delayed.
  */
 + (void)removeUnusedDownloadedFiles;
 
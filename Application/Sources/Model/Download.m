@@ -7,6 +7,7 @@
 #import "Download.h"
 
 #import "DownloadSession.h"
+#import "History.h"
 #import "PlaySRG-Swift.h"
 #import "PlayErrors.h"
 #import "PlayLogger.h"
@@ -14,6 +15,8 @@
 @import FXReachability;
 @import libextobjc;
 @import SRGDataProviderNetwork;
+@import SRGUserData;
+@import UIKit;
 
 NSString * const DownloadStateDidChangeNotification = @"DownloadStateDidChangeNotification";
 NSString * const DownloadStateKey = @"DownloadState";
@@ -21,6 +24,23 @@ NSString * const DownloadStateKey = @"DownloadState";
 static NSMutableDictionary<NSString *, Download *> *s_downloadsDictionary;
 static NSArray<Download *> *s_sortedDownloads;
 
+// Size of downloaded files, by download URN. Only accessed from the main thread
+static NSMutableDictionary<NSString *, NSNumber *> *s_downloadFileSizes;
+static long long s_storageQuota;
+
+// Delay after launch before unused downloaded files are removed
+static const NSTimeInterval kDownloadedFilesCleanupDelay = 10.;
+// Files saved this recently might belong to downloads which just finished, and are never removed as unused
+static const NSTimeInterval kDownloadedFilesCleanupGracePeriod = 60.;
+
+// Journaled store state, only accessed from the store queue
+static dispatch_queue_t s_storeQueue;
+static NSMutableDictionary<NSString *, NSData *> *s_storeRecords;
+static NSMutableDictionary<NSString *, NSDictionary *> *s_storeBackupDictionaries;
+static NSUInteger s_storeLogRecordCount;
+
+static long long DownloadFileSize(NSURL *fileURL);
+
 @interface Download ()
 
 @property (nonatomic) SRGMedia *media;
@@ -71,10 +91,15 @@ static NSArray<Download *> *s_sortedDownloads;
 #pragma mark Class methods
 
 /**
- *  Downloads are saved with AutoCoding in the "downloadsFilePath" file
+ *  Downloads are saved with AutoCoding, one record per URN, in a journaled store made of a snapshot ("downloadsStoreFilePath")
+ *  and a log of changes made since the snapshot was written ("downloadsStoreLogFilePath"). Changes are written on a background
+ *  serial queue, and the log is compacted into the snapshot when it grows too large.
+ *  Downloads saved by former versions in the "downloadsFilePath" file are migrated to the store.
  *  A corrupted file, or an update of the model object, or the related object model linked to it, can broke the download restoration.
  *  In the case, the initializer try to load the "downloadsBackupFilePath" file.
- *  The "downloadsBackupFilePath" file is a simple plsit file without the related object.
+ *  The "downloadsBackupFilePath" file is a simple plsit file without the related object, regenerated lazily when the store is
+ *  compacted or when the application enters the background. Since it might therefore contain removed downloads, it is only
+ *  used when the store cannot be loaded at all.
  *  It creates a light download object, with just information to display it and play offline file.
  */
 
@@ -84,20 +109,35 @@ static NSArray<Download *> *s_sortedDownloads;
         return;
     }
     
-    @try {
-        s_downloadsDictionary = [self loadDownloadsDictionary];
-    }
-    @catch (NSException *exception) {
-        PlayLogWarning(@"download", @"Download migration failed. Use backup dictionary instead");
-    }
+    s_storeQueue = dispatch_queue_create("ch.srgssr.play.downloads.store", DISPATCH_QUEUE_SERIAL);
+    s_storeRecords = [NSMutableDictionary dictionary];
+    s_storeBackupDictionaries = [NSMutableDictionary dictionary];
+    s_downloadFileSizes = [NSMutableDictionary dictionary];
+    
+    s_downloadsDictionary = [self loadDownloadsStore];
     
-    // If model objects changed, or the plist file is corrupted,
-    // We try to load lazy downloads from the backup file.
-    if (s_downloadsDictionary.count == 0) {
-        NSDictionary *backupDownload = [self loadDownloadsBackupDictionary];
-        if (backupDownload.count > 0) {
-            s_downloadsDictionary = backupDownload.mutableCopy;
-            [self saveDownloadsDictionary];
+    // Migrate downloads saved by former versions
+    if (! s_downloadsDictionary) {
+        @try {
+            s_downloadsDictionary = [self loadDownloadsDictionary];
+        }
+        @catch (NSException *exception) {
+            PlayLogWarning(@"download", @"Download migration failed. Use backup dictionary instead");
+        }
+        
+        if (s_downloadsDictionary.count > 0) {
+            [self saveAllDownloads];
+        }
+        
+        // If model objects changed, or the plist file is corrupted,
+        // We try to load lazy downloads from the backup file.
+        // An empty store is valid and must not be replaced with the backup, which might contain removed downloads.
+        if (s_downloadsDictionary.count == 0) {
+            NSDictionary *backupDownload = [self loadDownloadsBackupDictionary];
+            if (backupDownload.count > 0) {
+                s_downloadsDictionary = backupDownload.mutableCopy;
+                [self saveAllDownloads];
+            }
         }
     }
     
@@ -106,11 +146,16 @@ static NSArray<Download *> *s_sortedDownloads;
         s_downloadsDictionary = [NSMutableDictionary dictionary];
     }
     
-    // Start downloads
+    [NSNotificationCenter.defaultCenter addObserver:self
+                                           selector:@selector(downloadApplicationDidEnterBackground:)
+                                               name:UIApplicationDidEnterBackgroundNotification
+                                             object:nil];
+    
+    // Start downloads. All of them must be registered before tasks from a previous application session are matched
     [s_downloadsDictionary.allValues enumerateObjectsUsingBlock:^(Download * _Nonnull download, NSUInteger idx, BOOL * _Nonnull stop) {
         [download setNeedsStateUpdateSilent:YES];
-        [DownloadSession.sharedDownloadSession addDownload:download];
     }];
+    [DownloadSession.sharedDownloadSession restoreDownloads:s_downloadsDictionary.allValues];
 }
 
 + (NSString *)downloadsFilePath
@@ -154,12 +199,262 @@ static NSArray<Download *> *s_sortedDownloads;
     return downloadsDictionary;
 }
 
-+ (void)saveDownloadsDictionary
+#pragma mark Store
+
++ (NSString *)downloadsStoreFilePath
+{
+    NSString *libraryDirectoryPath = NSSearchPathForDirectoriesInDomains(NSLibraryDirectory, NSUserDomainMask, YES).firstObject;
+    return [libraryDirectoryPath stringByAppendingPathComponent:@"downloadsStore.plist"];
+}
+
++ (NSString *)downloadsStoreLogFilePath
+{
+    NSString *libraryDirectoryPath = NSSearchPathForDirectoriesInDomains(NSLibraryDirectory, NSUserDomainMask, YES).firstObject;
+    return [libraryDirectoryPath stringByAppendingPathComponent:@"downloadsStore.log"];
+}
+
+// Apply a log record to store records. Only call on the store queue.
++ (void)applyStoreLogRecord:(NSDictionary *)logRecord
 {
-    NSData *data = [NSKeyedArchiver archivedDataWithRootObject:s_downloadsDictionary requiringSecureCoding:NO error:NULL];
-    [data writeToFile:[self downloadsFilePath] atomically:YES];
+    NSString *URN = logRecord[@"URN"];
+    if (! [URN isKindOfClass:NSString.class]) {
+        return;
+    }
     
-    [self saveDownloadsBackupDictionary];
+    NSData *data = logRecord[@"data"];
+    NSDictionary *backupDictionary = logRecord[@"backup"];
+    if ([data isKindOfClass:NSData.class] && [backupDictionary isKindOfClass:NSDictionary.class]) {
+        s_storeRecords[URN] = data;
+        s_storeBackupDictionaries[URN] = backupDictionary;
+    }
+    else {
+        [s_storeRecords removeObjectForKey:URN];
+        [s_storeBackupDictionaries removeObjectForKey:URN];
+    }
+}
+
++ (NSMutableDictionary<NSString *, Download *> *)loadDownloadsStore
+{
+    NSString *storeFilePath = [self downloadsStoreFilePath];
+    NSDictionary *snapshot = [NSDictionary dictionaryWithContentsOfFile:storeFilePath];
+    if (! snapshot) {
+        // A corrupted snapshot cannot be loaded
+        if ([NSFileManager.defaultManager fileExistsAtPath:storeFilePath]) {
+            PlayLogError(@"download", @"Could not load downloads store snapshot");
+            return nil;
+        }
+        else if (! [NSFileManager.defaultManager fileExistsAtPath:[self downloadsStoreLogFilePath]]) {
+            return nil;
+        }
+    }
+    
+    __block NSMutableDictionary<NSString *, Download *> *downloadsDictionary = nil;
+    dispatch_sync(s_storeQueue, ^{
+        NSDictionary *records = snapshot[@"records"];
+        NSDictionary *backupDictionaries = snapshot[@"backup"];
+        s_storeRecords = [records isKindOfClass:NSDictionary.class] ? records.mutableCopy : [NSMutableDictionary dictionary];
+        s_storeBackupDictionaries = [backupDictionaries isKindOfClass:NSDictionary.class] ? backupDictionaries.mutableCopy : [NSMutableDictionary dictionary];
+        
+        // Replay the log. Each record is a binary property list, prefixed with its length. A truncated last record
+        // (e.g. if the application was killed while writing it) is ignored.
+        s_storeLogRecordCount = 0;
+        NSData *logData = [NSData dataWithContentsOfFile:[self downloadsStoreLogFilePath]];
+        NSUInteger offset = 0;
+        while (offset + sizeof(uint32_t) <= logData.length) {
+            uint32_t length = 0;
+            [logData getBytes:&length range:NSMakeRange(offset, sizeof(uint32_t))];
+            length = CFSwapInt32LittleToHost(length);
+            offset += sizeof(uint32_t);
+            
+            if (offset + length > logData.length) {
+                break;
+            }
+            
+            NSData *recordData = [logData subdataWithRange:NSMakeRange(offset, length)];
+            offset += length;
+            
+            NSDictionary *logRecord = [NSPropertyListSerialization propertyListWithData:recordData options:NSPropertyListImmutable format:NULL error:NULL];
+            if ([logRecord isKindOfClass:NSDictionary.class]) {
+                [self applyStoreLogRecord:logRecord];
+            }
+            s_storeLogRecordCount++;
+        }
+        
+        downloadsDictionary = [NSMutableDictionary dictionary];
+        [s_storeRecords enumerateKeysAndObjectsUsingBlock:^(NSString * _Nonnull URN, NSData * _Nonnull data, BOOL * _Nonnull stop) {
+            Download *download = nil;
+            @try {
+                NSKeyedUnarchiver *unarchiver = [[NSKeyedUnarchiver alloc] initForReadingFromData:data error:NULL];
+                unarchiver.requiresSecureCoding = NO;
+                download = [unarchiver decodeObjectForKey:NSKeyedArchiveRootObjectKey];
+            }
+            @catch (NSException *exception) {
+                PlayLogWarning(@"download", @"Could not load download for key %@. Reason: %@", URN, exception);
+            }
+            
+            if ([download isKindOfClass:Download.class]) {
+                downloadsDictionary[URN] = download;
+            }
+            else {
+                // Fall back to the backup dictionary, if any
+                NSDictionary *backupDictionary = s_storeBackupDictionaries[URN];
+                Download *backupDownload = backupDictionary ? [[Download alloc] initWithDictionary:backupDictionary] : nil;
+                if (backupDownload) {
+                    downloadsDictionary[URN] = backupDownload;
+                }
+                else {
+                    PlayLogError(@"download", @"Could not open download for key %@. Skipped", URN);
+                }
+            }
+        }];
+    });
+    return downloadsDictionary;
+}
+
+// Write the snapshot and the backup file, and clear the log. Only call on the store queue.
++ (void)compactDownloadsStore
+{
+    NSError *plistError = nil;
+    NSData *snapshotData = [NSPropertyListSerialization dataWithPropertyList:@{ @"records" : s_storeRecords.copy,
+                                                                                @"backup" : s_storeBackupDictionaries.copy }
+                                                                      format:NSPropertyListBinaryFormat_v1_0
+                                                                     options:0
+                                                                       error:&plistError];
+    if (plistError) {
+        PlayLogError(@"download", @"Could not save downloads data. Reason: %@", plistError);
+        return;
+    }
+    
+    NSError *writeError = nil;
+    [snapshotData writeToFile:[self downloadsStoreFilePath] options:NSDataWritingAtomic error:&writeError];
+    if (writeError) {
+        PlayLogError(@"download", @"Could not save downloads data. Reason: %@", writeError);
+        return;
+    }
+    
+    [NSFileManager.defaultManager removeItemAtPath:[self downloadsStoreLogFilePath] error:NULL];
+    s_storeLogRecordCount = 0;
+    
+    [self saveDownloadsBackupDictionary:s_storeBackupDictionaries.copy];
+}
+
+// Append a record to the log. Only call on the store queue.
++ (void)appendStoreLogRecord:(NSDictionary *)logRecord
+{
+    [self applyStoreLogRecord:logRecord];
+    
+    static const NSUInteger kLogCompactionThreshold = 100;
+    if (s_storeLogRecordCount >= kLogCompactionThreshold) {
+        [self compactDownloadsStore];
+        return;
+    }
+    
+    NSError *plistError = nil;
+    NSData *recordData = [NSPropertyListSerialization dataWithPropertyList:logRecord
+                                                                    format:NSPropertyListBinaryFormat_v1_0
+                                                                   options:0
+                                                                     error:&plistError];
+    if (plistError) {
+        PlayLogError(@"download", @"Could not save downloads data. Reason: %@", plistError);
+        return;
+    }
+    
+    NSString *logFilePath = [self downloadsStoreLogFilePath];
+    if (! [NSFileManager.defaultManager fileExistsAtPath:logFilePath]) {
+        [NSFileManager.defaultManager createFileAtPath:logFilePath contents:nil attributes:nil];
+    }
+    
+    NSError *writeError = nil;
+    NSFileHandle *fileHandle = [NSFileHandle fileHandleForWritingToURL:[NSURL fileURLWithPath:logFilePath] error:&writeError];
+    if (fileHandle) {
+        uint32_t length = CFSwapInt32HostToLittle((uint32_t)recordData.length);
+        NSMutableData *data = [NSMutableData dataWithBytes:&length length:sizeof(uint32_t)];
+        [data appendData:recordData];
+        
+        if ([fileHandle seekToEndReturningOffset:NULL error:&writeError]) {
+            [fileHandle writeData:data error:&writeError];
+        }
+        [fileHandle closeAndReturnError:NULL];
+    }
+    
+    if (writeError) {
+        PlayLogError(@"download", @"Could not save downloads data. Reason: %@", writeError);
+        
+        // Fallback to a full snapshot
+        [self compactDownloadsStore];
+        return;
+    }
+    
+    s_storeLogRecordCount++;
+}
+
++ (void)saveDownload:(Download *)download
+{
+    if (! download.URN) {
+        return;
+    }
+    
+    // Only the saved download is archived on the calling thread, file operations are performed in the background
+    NSData *data = [NSKeyedArchiver archivedDataWithRootObject:download requiringSecureCoding:NO error:NULL];
+    if (! data) {
+        PlayLogError(@"download", @"Could not archive download %@", download.URN);
+        return;
+    }
+    
+    NSDictionary *logRecord = @{ @"URN" : download.URN,
+                                 @"data" : data,
+                                 @"backup" : download.backupDictionary };
+    dispatch_async(s_storeQueue, ^{
+        [self appendStoreLogRecord:logRecord];
+    });
+}
+
++ (void)saveRemovalOfDownloadWithURN:(NSString *)URN
+{
+    dispatch_async(s_storeQueue, ^{
+        [self appendStoreLogRecord:@{ @"URN" : URN }];
+    });
+}
+
++ (void)saveAllDownloads
+{
+    NSMutableDictionary<NSString *, NSData *> *records = [NSMutableDictionary dictionary];
+    NSMutableDictionary<NSString *, NSDictionary *> *backupDictionaries = [NSMutableDictionary dictionary];
+    [s_downloadsDictionary enumerateKeysAndObjectsUsingBlock:^(NSString * _Nonnull URN, Download * _Nonnull download, BOOL * _Nonnull stop) {
+        NSData *data = [NSKeyedArchiver archivedDataWithRootObject:download requiringSecureCoding:NO error:NULL];
+        if (data) {
+            records[URN] = data;
+            backupDictionaries[URN] = download.backupDictionary;
+        }
+    }];
+    
+    dispatch_async(s_storeQueue, ^{
+        s_storeRecords = records;
+        s_storeBackupDictionaries = backupDictionaries;
+        [self compactDownloadsStore];
+    });
+}
+
++ (void)downloadApplicationDidEnterBackground:(NSNotification *)notification
+{
+    // Compact the store so that the backup file is up-to-date. Ask for some time so that files are written before
+    // the application is suspended.
+    // The background task identifier is only accessed from the main thread.
+    __block UIBackgroundTaskIdentifier backgroundTaskIdentifier = UIBackgroundTaskInvalid;
+    void (^endBackgroundTask)(void) = ^{
+        if (backgroundTaskIdentifier != UIBackgroundTaskInvalid) {
+            [UIApplication.sharedApplication endBackgroundTask:backgroundTaskIdentifier];
+            backgroundTaskIdentifier = UIBackgroundTaskInvalid;
+        }
+    };
+    backgroundTaskIdentifier = [UIApplication.sharedApplication beginBackgroundTaskWithName:@"DownloadsStoreCompaction" expirationHandler:endBackgroundTask];
+    
+    dispatch_async(s_storeQueue, ^{
+        if (s_storeLogRecordCount != 0) {
+            [self compactDownloadsStore];
+        }
+        dispatch_async(dispatch_get_main_queue(), endBackgroundTask);
+    });
 }
 
 + (NSString *)downloadsBackupFilePath
@@ -189,14 +484,9 @@ static NSArray<Download *> *s_sortedDownloads;
     return downloadsBackupDictionary.copy;
 }
 
-+ (void)saveDownloadsBackupDictionary
++ (void)saveDownloadsBackupDictionary:(NSDictionary<NSString *, NSDictionary *> *)downloadsBackupDictionary
 {
     // Backup file has only basic Objective-C objects
-    NSMutableDictionary *downloadsBackupDictionary = [NSMutableDictionary dictionary];
-    [s_downloadsDictionary enumerateKeysAndObjectsUsingBlock:^(NSString * _Nonnull URN, Download * _Nonnull download, BOOL * _Nonnull stop) {
-        downloadsBackupDictionary[URN] = download.backupDictionary;
-    }];
-    
     NSError *plistError = nil;
     NSData *plistData = [NSPropertyListSerialization dataWithPropertyList:downloadsBackupDictionary
                                                                    format:NSPropertyListXMLFormat_v1_0
@@ -226,7 +516,7 @@ static NSArray<Download *> *s_sortedDownloads;
     s_downloadsDictionary[download.URN] = download;
     s_sortedDownloads = nil;            // Invalidate sorted download cache
     
-    [self saveDownloadsDictionary];
+    [self saveDownload:download];
     
     [DownloadSession.sharedDownloadSession addDownload:download];
     
@@ -251,17 +541,134 @@ static NSArray<Download *> *s_sortedDownloads;
 
 + (void)removeUnusedDownloadedFiles
 {
-    NSArray *downloadedMediaFilesURLs = [Download.downloads valueForKey:@keypath(Download.new, localMediaFileURL)];
-    NSArray *downloadedImageFilesURLs = [Download.downloads valueForKey:@keypath(Download.new, localImageFileURL)];
-    NSArray *allDownloadedFilesURLs = [[@[] arrayByAddingObjectsFromArray:downloadedMediaFilesURLs] arrayByAddingObjectsFromArray:downloadedImageFilesURLs];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kDownloadedFilesCleanupDelay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        [self cleanupDownloadedFiles];
+    });
+}
+
++ (void)cleanupDownloadedFiles
+{
+    // Index files in use by file name
+    NSMutableDictionary<NSString *, NSString *> *URNsByFileName = [NSMutableDictionary dictionary];
+    for (Download *download in s_downloadsDictionary.allValues) {
+        if (download.localMediaFileName) {
+            URNsByFileName[download.localMediaFileName] = download.URN;
+        }
+        if (download.localImageFileName) {
+            URNsByFileName[download.localImageFileName] = download.URN;
+        }
+    }
+    NSSet<NSString *> *URNs = [NSSet setWithArray:s_downloadsDictionary.allKeys];
     NSString *folderPath = [self downloadsDirectoryURLString];
-    NSError *error;
-    for (NSString *fileName in [NSFileManager.defaultManager contentsOfDirectoryAtPath:folderPath error:&error]) {
-        NSURL *fileURL = [NSURL fileURLWithPath:[folderPath stringByAppendingPathComponent:fileName]];
-        if (! [allDownloadedFilesURLs containsObject:fileURL]) {
-            [NSFileManager.defaultManager removeItemAtURL:fileURL error:&error];
+    NSDate *date = NSDate.date;
+    
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_BACKGROUND, 0), ^{
+        NSMutableDictionary<NSString *, NSNumber *> *fileSizes = [NSMutableDictionary dictionary];
+        NSUInteger removedFileCount = 0;
+        
+        NSArray<NSURLResourceKey> *keys = @[ NSURLFileSizeKey, NSURLContentModificationDateKey ];
+        NSArray<NSURL *> *fileURLs = [NSFileManager.defaultManager contentsOfDirectoryAtURL:[NSURL fileURLWithPath:folderPath]
+                                                                 includingPropertiesForKeys:keys
+                                                                                    options:0
+                                                                                      error:NULL];
+        for (NSURL *fileURL in fileURLs) {
+            NSDictionary<NSURLResourceKey, id> *resourceValues = [fileURL resourceValuesForKeys:keys error:NULL];
+            
+            NSString *URN = URNsByFileName[fileURL.lastPathComponent];
+            if (URN) {
+                long long fileSize = [resourceValues[NSURLFileSizeKey] longLongValue];
+                fileSizes[URN] = @(fileSizes[URN].longLongValue + fileSize);
+                continue;
+            }
+            
+            NSDate *modificationDate = resourceValues[NSURLContentModificationDateKey];
+            if (modificationDate && [date timeIntervalSinceDate:modificationDate] > kDownloadedFilesCleanupGracePeriod) {
+                [NSFileManager.defaultManager removeItemAtURL:fileURL error:NULL];
+                removedFileCount++;
+            }
+        }
+        
+        // Resume data of partially downloaded files
+        [DownloadSession.sharedDownloadSession removeResumeDataExceptForDownloadURNs:URNs];
+        
+        PlayLogDebug(@"download", @"%@ unused downloaded files removed", @(removedFileCount));
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [s_downloadFileSizes addEntriesFromDictionary:fileSizes];
+            [self applyStorageQuota];
+        });
+    });
+}
+
++ (long long)downloadedFilesSize
+{
+    long long size = 0;
+    for (Download *download in s_downloadsDictionary.allValues) {
+        size += download.size;
+    }
+    return size;
+}
+
++ (void)applyStorageQuota
+{
+    if (s_storageQuota <= 0 || [self downloadedFilesSize] <= s_storageQuota) {
+        return;
+    }
+    
+    NSMutableArray<NSString *> *URNs = [NSMutableArray array];
+    for (Download *download in s_downloadsDictionary.allValues) {
+        if (download.localMediaFileName) {
+            [URNs addObject:download.URN];
         }
     }
+    
+    // Least recently played first
+    NSPredicate *predicate = [NSPredicate predicateWithFormat:@"%K IN %@", @keypath(SRGHistoryEntry.new, uid), URNs];
+    NSSortDescriptor *sortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@keypath(SRGHistoryEntry.new, date) ascending:YES];
+    [SRGUserData.currentUserData.history historyEntriesMatchingPredicate:predicate sortedWithDescriptors:@[sortDescriptor] completionBlock:^(NSArray<SRGHistoryEntry *> * _Nullable historyEntries, NSError * _Nullable error) {
+        if (error) {
+            return;
+        }
+        
+        NSMutableDictionary<NSString *, NSNumber *> *playbackPositions = [NSMutableDictionary dictionary];
+        NSMutableArray<NSString *> *playedURNs = [NSMutableArray array];
+        for (SRGHistoryEntry *historyEntry in historyEntries) {
+            if (historyEntry.uid) {
+                playbackPositions[historyEntry.uid] = @(CMTimeGetSeconds(historyEntry.lastPlaybackTime));
+                [playedURNs addObject:historyEntry.uid];
+            }
+        }
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            long long size = [self downloadedFilesSize];
+            
+            NSMutableArray<Download *> *evictedDownloads = [NSMutableArray array];
+            for (NSString *URN in playedURNs) {
+                if (size <= s_storageQuota) {
+                    break;
+                }
+                
+                Download *download = s_downloadsDictionary[URN];
+                if (! download.localMediaFileName) {
+                    continue;
+                }
+                
+                // Only remove downloads which have been played entirely
+                NSTimeInterval playbackPosition = playbackPositions[URN].doubleValue;
+                if (HistoryPlaybackProgress(playbackPosition, download.duration / 1000.) != 1.f) {
+                    continue;
+                }
+                
+                size -= download.size;
+                [evictedDownloads addObject:download];
+            }
+            
+            if (evictedDownloads.count != 0) {
+                PlayLogInfo(@"download", @"%@ played downloads removed to apply the storage quota", @(evictedDownloads.count));
+                [self removeDownloads:evictedDownloads.copy];
+            }
+        });
+    }];
 }
 
 + (void)updateUnplayableDownloads
@@ -280,6 +687,7 @@ static NSArray<Download *> *s_sortedDownloads;
                 
                 if ([NSFileManager.defaultManager fileExistsAtPath:destinationPath]) {
                     download.localMediaFileName = localMediaFileName;
+                    [self saveDownload:download];
                 }
                 else {
                     [unplayableDownloads addObject:download];
@@ -291,11 +699,21 @@ static NSArray<Download *> *s_sortedDownloads;
         }
     }
     [Download removeDownloads:unplayableDownloads.copy];
-    [self saveDownloadsDictionary];
 }
 
 #pragma mark Public class methods
 
++ (long long)storageQuota
+{
+    return s_storageQuota;
+}
+
++ (void)setStorageQuota:(long long)storageQuota
+{
+    s_storageQuota = storageQuota;
+    [self applyStorageQuota];
+}
+
 + (NSArray<Download *> *)downloads
 {
     if (! s_sortedDownloads) {
@@ -323,7 +741,7 @@ static NSArray<Download *> *s_sortedDownloads;
             download = [[Download alloc] initWithMedia:media];
             s_downloadsDictionary[media.URN] = download;
             s_sortedDownloads = nil;            // Invalidate sorted download cache
-            [self saveDownloadsDictionary];
+            [self saveDownload:download];
             
             download.state = DownloadStateAdded;
             
@@ -350,6 +768,7 @@ static NSArray<Download *> *s_sortedDownloads;
         }
         
         [s_downloadsDictionary removeObjectForKey:download.URN];
+        [self saveRemovalOfDownloadWithURN:download.URN];
         [DownloadSession.sharedDownloadSession removeDownload:download];
         [download removeLocalFiles];
         
@@ -358,7 +777,6 @@ static NSArray<Download *> *s_sortedDownloads;
     }
     
     s_sortedDownloads = nil;            // Invalidate sorted download cache
-    [self saveDownloadsDictionary];
     
     [UserInteractionEvent removeFromDownloads:removedDownloads.copy];
 }
@@ -370,7 +788,7 @@ static NSArray<Download *> *s_sortedDownloads;
     // Update download with the object
     if (download && (! download.media || ! [media isEqual:download.media])) {
         [download updateWithMedia:media];
-        [self saveDownloadsDictionary];
+        [self saveDownload:download];
     }
     
     return download;
@@ -394,7 +812,7 @@ static NSArray<Download *> *s_sortedDownloads;
     
     s_sortedDownloads = nil;
     
-    [self saveDownloadsDictionary];
+    [self saveAllDownloads];
     
     [downloads enumerateObjectsUsingBlock:^(Download * _Nonnull download, NSUInteger idx, BOOL * _Nonnull stop) {
         download.state = DownloadStateRemoved;
@@ -566,10 +984,12 @@ static NSArray<Download *> *s_sortedDownloads;
                      (excludeFileFromBackup) ? @"" : @"\nError: ", (excludeFileFromBackup) ? @"" : error);
         self.localMediaFileName = mediaFileName;
         if ([Download downloadForMedia:self.media]) {
-            [Download saveDownloadsDictionary];
+            [Download saveDownload:self];
         }
         dispatch_async(dispatch_get_main_queue(), ^{
+            s_downloadFileSizes[self.URN] = nil;
             [self setNeedsStateUpdate];
+            [Download applyStorageQuota];
         });
         return YES;
     }
@@ -590,9 +1010,10 @@ static NSArray<Download *> *s_sortedDownloads;
     if (localURL && [NSFileManager.defaultManager moveItemAtURL:tmpFile toURL:localURL error:&error] && ! error) {
         self.localImageFileName = imageFileName;
         if ([Download downloadForMedia:self.media]) {
-            [Download saveDownloadsDictionary];
+            [Download saveDownload:self];
         }
         dispatch_async(dispatch_get_main_queue(), ^{
+            s_downloadFileSizes[self.URN] = nil;
             [self setNeedsStateUpdate];
         });
         return YES;
@@ -605,6 +1026,8 @@ static NSArray<Download *> *s_sortedDownloads;
 
 - (void)removeLocalFiles
 {
+    s_downloadFileSizes[self.URN] = nil;
+    
     NSError *error;
     if (self.localMediaFileURL) {
         [NSFileManager.defaultManager removeItemAtURL:self.localMediaFileURL error:&error];
@@ -836,13 +1259,21 @@ static NSArray<Download *> *s_sortedDownloads;
 
 - (long long)size
 {
-    if (! self.localMediaFileURL) {
+    if (! self.localMediaFileName) {
         return 0;
     }
     
-    NSDictionary *fileAttributes = [NSFileManager.defaultManager attributesOfItemAtPath:self.localMediaFileURL.path error:NULL];
-    NSNumber *fileSize = [fileAttributes objectForKey:NSFileSize];
-    return [fileSize longLongValue];
+    NSNumber *size = s_downloadFileSizes[self.URN];
+    if (! size) {
+        NSURL *localMediaFileURL = self.localMediaFileURL;
+        if (! localMediaFileURL) {
+            return 0;
+        }
+        
+        size = @(DownloadFileSize(localMediaFileURL) + DownloadFileSize(self.localImageFileURL));
+        s_downloadFileSizes[self.URN] = size;
+    }
+    return size.longLongValue;
 }
 
 - (SRGMedia *)media
@@ -892,3 +1323,15 @@ static NSArray<Download *> *s_sortedDownloads;
 }
 
 @end
+
+#pragma mark Functions
+
+static long long DownloadFileSize(NSURL *fileURL)
+{
+    if (! fileURL) {
+        return 0;
+    }
+    
+    NSDictionary *fileAttributes = [NSFileManager.defaultManager attributesOfItemAtPath:fileURL.path error:NULL];
+    return [[fileAttributes objectForKey:NSFileSize] longLongValue];
+}
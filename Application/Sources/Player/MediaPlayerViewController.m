@@ -1367,11 +1367,7 @@ static NSDateComponentsFormatter *MediaPlayerViewControllerSkipIntervalAccessibi
 {
     NSString *subdivisionURN = self.letterboxController.subdivision.URN;
     if (subdivisionURN) {
-        NSPredicate *predicate = [NSPredicate predicateWithFormat:@"%K == %@", @keypath(SRGProgram.new, mediaURN), subdivisionURN];
-        SRGProgram *program = [self.programComposition.programs filteredArrayUsingPredicate:predicate].firstObject;
-        if (program) {
-            return program;
-        }
+        return [self.programComposition play_programWithMediaURN:subdivisionURN];
     }
     return nil;
 }
@@ -14,8 +14,7 @@ final class ProgramCellViewModel: ObservableObject {
     @Published private(set) var date = Date()
 
     init() {
-        Timer.publish(every: 10, on: .main, in: .common)
-            .autoconnect()
+        WallClock.shared.publisher(every: 10, boundary: { [weak self] in self?.data?.program.nextBoundary(after: Date()) })
             .assign(to: &$date)
     }
 
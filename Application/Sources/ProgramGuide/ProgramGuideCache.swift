@@ -0,0 +1,253 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+import Combine
+import SRGDataProviderModel
+
+/**
+ *  Disk cache of TV program guide days, so that the guide can be displayed immediately, even offline or on slow
+ *  networks.
+ *
+ *  Days are stored per bouquet, with programs sorted by start date and the date at which they were saved. Channels are
+ *  stored once per bouquet and only referenced by uid from days. The channel list last received for a bouquet is also
+ *  kept, so that it is available before any day has been loaded.
+ *
+ *  Can be used from any thread.
+ */
+enum ProgramGuideCache {
+    /// Identifies a bouquet (main bouquet or other bouquet of a vendor)
+    struct Key: Hashable {
+        let name: String
+        let external: Bool
+    }
+
+    /// Programs cached for a day
+    struct Day {
+        let programCompositions: [PlayProgramComposition]
+        /// `true` iff the programs were saved after the day and all its programs had ended, so that they are final.
+        let isFinal: Bool
+    }
+
+    private struct ChannelRecords {
+        var channels: [String: SRGChannel]
+        var channelUids: [String]
+    }
+
+    private struct DayKey: Hashable {
+        let key: Key
+        let day: SRGDay
+    }
+
+    /// Days older than this delay are removed from the disk
+    private static let maximumAge: TimeInterval = 14 * 24 * 60 * 60
+    private static let maximumMemoryDayCount = 10
+
+    // All state is only accessed from the cache queue
+    private static let queue = DispatchQueue(label: "ch.srgssr.play.program-guide-cache", qos: .userInitiated)
+    private static var channelRecords = [Key: ChannelRecords]()
+    private static var days = [DayKey: Day]()
+    private static var dayKeys = [DayKey]()
+    private static var isPruned = false
+
+    private static let directoryUrl: URL = {
+        let cachesDirectoryUrl = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask).first!
+        return cachesDirectoryUrl.appendingPathComponent("ProgramGuideCache", isDirectory: true)
+    }()
+
+    /**
+     *  Publishes the programs cached for a bouquet and a day, or `nil` if none.
+     */
+    static func day(for key: Key, day: SRGDay) -> AnyPublisher<Day?, Never> {
+        Deferred {
+            Future { promise in
+                queue.async {
+                    promise(.success(cachedDay(for: key, day: day)))
+                }
+            }
+        }
+        .eraseToAnyPublisher()
+    }
+
+    /**
+     *  Publishes the channel list last received for a bouquet, or `nil` if none.
+     */
+    static func channels(for key: Key) -> AnyPublisher<[PlayChannel]?, Never> {
+        Deferred {
+            Future { promise in
+                queue.async {
+                    guard let records = records(for: key), !records.channelUids.isEmpty else {
+                        promise(.success(nil))
+                        return
+                    }
+                    let channels = records.channelUids
+                        .compactMap { records.channels[$0] }
+                        .map { PlayChannel(wrappedValue: $0, external: key.external) }
+                    promise(.success(channels))
+                }
+            }
+        }
+        .eraseToAnyPublisher()
+    }
+
+    /**
+     *  Save the (complete) programs received for a bouquet and a day in the background.
+     */
+    static func save(_ programCompositions: [PlayProgramComposition], for key: Key, day: SRGDay) {
+        let saveDate = Date()
+        queue.async {
+            var records = records(for: key) ?? ChannelRecords(channels: [:], channelUids: [])
+            records.channelUids = programCompositions.map(\.channel.wrappedValue.uid)
+            for programComposition in programCompositions {
+                records.channels[programComposition.channel.wrappedValue.uid] = programComposition.channel.wrappedValue
+            }
+            channelRecords[key] = records
+
+            let sortedProgramCompositions = programCompositions.map { programComposition in
+                PlayProgramComposition(
+                    channel: programComposition.channel.wrappedValue,
+                    programs: programComposition.programs?.sorted { $0.startDate < $1.startDate },
+                    external: key.external
+                )
+            }
+            let cachedDay = Day(programCompositions: sortedProgramCompositions, isFinal: isFinal(sortedProgramCompositions, day: day, saveDate: saveDate))
+            store(cachedDay, for: DayKey(key: key, day: day))
+
+            let channelsArchive: [String: Any] = [
+                "channels": records.channels,
+                "channelUids": records.channelUids
+            ]
+            let dayArchive: [String: Any] = [
+                "channelUids": sortedProgramCompositions.map(\.channel.wrappedValue.uid),
+                "programs": sortedProgramCompositions.map { $0.programs ?? [] },
+                "hasPrograms": sortedProgramCompositions.map { $0.programs != nil },
+                "saveDate": saveDate
+            ]
+
+            do {
+                try FileManager.default.createDirectory(at: directoryUrl, withIntermediateDirectories: true)
+                try write(channelsArchive, to: channelsFileUrl(for: key))
+                try write(dayArchive, to: dayFileUrl(for: key, day: day))
+            } catch {
+                PlayLogWarning(category: "programGuideCache", message: "Could not save programs to cache. Reason: \(error)")
+            }
+
+            pruneIfNeeded()
+        }
+    }
+
+    // MARK: Cache (cache queue only)
+
+    private static func cachedDay(for key: Key, day: SRGDay) -> Day? {
+        let dayKey = DayKey(key: key, day: day)
+        if let cachedDay = days[dayKey] {
+            return cachedDay
+        }
+
+        guard let records = records(for: key),
+              let dayArchive = read(from: dayFileUrl(for: key, day: day)),
+              let channelUids = dayArchive["channelUids"] as? [String],
+              let programs = dayArchive["programs"] as? [[SRGProgram]],
+              let hasPrograms = dayArchive["hasPrograms"] as? [Bool],
+              channelUids.count == programs.count, channelUids.count == hasPrograms.count else {
+            return nil
+        }
+
+        let programCompositions = channelUids.indices.compactMap { index -> PlayProgramComposition? in
+            guard let channel = records.channels[channelUids[index]] else { return nil }
+            return PlayProgramComposition(channel: channel, programs: hasPrograms[index] ? programs[index] : nil, external: key.external)
+        }
+
+        // Days saved by former versions have no save date and are never final
+        let saveDate = dayArchive["saveDate"] as? Date
+        let cachedDay = Day(programCompositions: programCompositions, isFinal: saveDate.map { isFinal(programCompositions, day: day, saveDate: $0) } ?? false)
+        store(cachedDay, for: dayKey)
+        return cachedDay
+    }
+
+    private static func isFinal(_ programCompositions: [PlayProgramComposition], day: SRGDay, saveDate: Date) -> Bool {
+        guard let nextDayDate = Calendar.srgDefault.date(byAdding: .day, value: 1, to: day.date) else { return false }
+        let endDate = programCompositions
+            .flatMap { $0.programs ?? [] }
+            .reduce(nextDayDate) { max($0, $1.endDate) }
+        return saveDate >= endDate
+    }
+
+    private static func store(_ cachedDay: Day, for dayKey: DayKey) {
+        days[dayKey] = cachedDay
+        dayKeys.removeAll { $0 == dayKey }
+        dayKeys.append(dayKey)
+
+        if dayKeys.count > maximumMemoryDayCount {
+            days[dayKeys.removeFirst()] = nil
+        }
+    }
+
+    private static func records(for key: Key) -> ChannelRecords? {
+        if let records = channelRecords[key] {
+            return records
+        }
+
+        guard let channelsArchive = read(from: channelsFileUrl(for: key)),
+              let channels = channelsArchive["channels"] as? [String: SRGChannel],
+              let channelUids = channelsArchive["channelUids"] as? [String] else {
+            return nil
+        }
+
+        let records = ChannelRecords(channels: channels, channelUids: channelUids)
+        channelRecords[key] = records
+        return records
+    }
+
+    private static func pruneIfNeeded() {
+        guard !isPruned else { return }
+        isPruned = true
+
+        let fileManager = FileManager.default
+        guard let fileUrls = try? fileManager.contentsOfDirectory(at: directoryUrl, includingPropertiesForKeys: [.contentModificationDateKey]) else { return }
+
+        let date = Date().addingTimeInterval(-maximumAge)
+        for fileUrl in fileUrls where fileUrl.lastPathComponent.hasPrefix("day-") {
+            guard let modificationDate = try? fileUrl.resourceValues(forKeys: [.contentModificationDateKey]).contentModificationDate,
+                  modificationDate < date else {
+                continue
+            }
+            try? fileManager.removeItem(at: fileUrl)
+        }
+    }
+
+    // MARK: Files
+
+    private static func fileName(for key: Key) -> String {
+        key.name.addingPercentEncoding(withAllowedCharacters: .alphanumerics) ?? key.name
+    }
+
+    private static func channelsFileUrl(for key: Key) -> URL {
+        directoryUrl.appendingPathComponent("channels-\(fileName(for: key))").appendingPathExtension("archive")
+    }
+
+    private static func dayFileUrl(for key: Key, day: SRGDay) -> URL {
+        let dayName = String(Int(day.date.timeIntervalSince1970))
+        return directoryUrl.appendingPathComponent("day-\(fileName(for: key))-\(dayName)").appendingPathExtension("archive")
+    }
+
+    private static func read(from fileUrl: URL) -> [String: Any]? {
+        guard let data = try? Data(contentsOf: fileUrl) else { return nil }
+
+        do {
+            let unarchiver = try NSKeyedUnarchiver(forReadingFrom: data)
+            unarchiver.requiresSecureCoding = false
+            return unarchiver.decodeObject(forKey: NSKeyedArchiveRootObjectKey) as? [String: Any]
+        } catch {
+            PlayLogWarning(category: "programGuideCache", message: "Could not read cached programs. Reason: \(error)")
+            return nil
+        }
+    }
+
+    private static func write(_ archive: [String: Any], to fileUrl: URL) throws {
+        let data = try NSKeyedArchiver.archivedData(withRootObject: archive, requiringSecureCoding: false)
+        try data.write(to: fileUrl, options: .atomic)
+    }
+}
@@ -53,18 +53,35 @@ final class ProgramGuideGridLayout: UICollectionViewLayout {
     static let horizontalSpacing: CGFloat = constant(iOS: 2, tvOS: 4)
     static let verticalSpacing: CGFloat = constant(iOS: 3, tvOS: 6)
 
+    /**
+     *  Item frames are stored before adjustment to the visible area, so that they can be reused as is when only the
+     *  bounds change. Item indices are bucketed by time slot for each section so that rect queries only visit items
+     *  which are likely visible.
+     */
     private struct LayoutData {
-        let layoutAttrs: [UICollectionViewLayoutAttributes]
-        let supplementaryAttrs: [UICollectionViewLayoutAttributes]
-        let decorationAttrs: [UICollectionViewLayoutAttributes]
+        let itemFrames: [[CGRect]]
+        let itemBuckets: [[Int: [Int]]]
+        var supplementaryAttrs: [UICollectionViewLayoutAttributes]
+        var decorationAttrs: [UICollectionViewLayoutAttributes]
         let dateInterval: DateInterval
+
+        var numberOfSections: Int {
+            itemFrames.count
+        }
+    }
+
+    private final class InvalidationContext: UICollectionViewLayoutInvalidationContext {
+        /// Set for invalidations only due to content offset changes, for which only sticky elements need to be updated.
+        var invalidatesBoundsOnly = false
     }
 
     private static let scale: CGFloat = constant(iOS: 430, tvOS: 900) / (60 * 60)
     private static let sectionHeight: CGFloat = constant(iOS: 80, tvOS: 120)
     private static let trailingMargin: CGFloat = 10
+    private static let slotWidth: CGFloat = 60 * 60 * scale
 
     private var layoutData: LayoutData?
+    private var needsLayoutData = true
     private var cancellables = Set<AnyCancellable>()
 
     private static func startDate(from snapshot: NSDiffableDataSourceSnapshot<ProgramGuideDailyViewModel.Section, ProgramGuideDailyViewModel.Item>) -> Date? {
@@ -84,7 +101,16 @@ final class ProgramGuideGridLayout: UICollectionViewLayout {
         return DateInterval(start: startDate, end: endDate(from: startDate))
     }
 
-    private static func frame(from startDate: Date, to endDate: Date, in dateInterval: DateInterval, forSection section: Int, collectionView: UICollectionView) -> CGRect {
+    private static func frame(from startDate: Date, to endDate: Date, in dateInterval: DateInterval, forSection section: Int) -> CGRect {
+        CGRect(
+            x: xPosition(at: startDate, in: dateInterval),
+            y: timelineHeight + CGFloat(section) * (sectionHeight + verticalSpacing),
+            width: max(endDate.timeIntervalSince(startDate) * scale - horizontalSpacing, 0),
+            height: sectionHeight
+        )
+    }
+
+    private static func adjustedFrame(_ frame: CGRect, in collectionView: UICollectionView) -> CGRect {
         // Adjust the frame of items which would be partially visible otherwise. Two different behaviors are implemented
         // for iOS and tvOS:
         //  - On iOS items partially visible on the left are adjusted to ensure their content is always visible.
@@ -100,40 +126,53 @@ final class ProgramGuideGridLayout: UICollectionViewLayout {
             width: constant(iOS: .greatestFiniteMagnitude, tvOS: max(collectionView.frame.width - channelHeaderWidth, 0)),
             height: .greatestFiniteMagnitude
         )
-        let frame = CGRect(
-            x: xPosition(at: startDate, in: dateInterval),
-            y: timelineHeight + CGFloat(section) * (sectionHeight + verticalSpacing),
-            width: max(endDate.timeIntervalSince(startDate) * scale - horizontalSpacing, 0),
-            height: sectionHeight
-        )
         return frame.intersects(visibleFrame) ? frame.intersection(visibleFrame) : frame
     }
 
     private static func layoutData(from snapshot: NSDiffableDataSourceSnapshot<ProgramGuideDailyViewModel.Section, ProgramGuideDailyViewModel.Item>, in collectionView: UICollectionView) -> LayoutData? {
         guard let dateInterval = dateInterval(from: snapshot) else { return nil }
-        let layoutAttrs = snapshot.sectionIdentifiers.enumeratedFlatMap { channel, section in
-            snapshot.itemIdentifiers(inSection: channel).enumeratedMap { item, index in
-                let attrs = UICollectionViewLayoutAttributes(forCellWith: IndexPath(item: index, section: section))
+        let itemFrames = snapshot.sectionIdentifiers.enumeratedMap { channel, section in
+            snapshot.itemIdentifiers(inSection: channel).map { item in
                 if let program = item.program {
-                    attrs.frame = frame(from: program.wrappedValue.startDate, to: program.extendedEndDate, in: dateInterval, forSection: section, collectionView: collectionView)
+                    frame(from: program.wrappedValue.startDate, to: program.extendedEndDate, in: dateInterval, forSection: section)
                 } else {
-                    attrs.frame = frame(from: dateInterval.start, to: dateInterval.end, in: dateInterval, forSection: section, collectionView: collectionView)
+                    frame(from: dateInterval.start, to: dateInterval.end, in: dateInterval, forSection: section)
                 }
-                return attrs
             }
         }
-        let headerAttrs = snapshot.sectionIdentifiers.enumeratedMap { _, section in
+        let itemBuckets = itemFrames.map { frames in
+            var buckets = [Int: [Int]]()
+            for (index, frame) in frames.enumerated() {
+                for slot in slots(from: frame.minX, to: frame.maxX, in: dateInterval) {
+                    buckets[slot, default: []].append(index)
+                }
+            }
+            return buckets
+        }
+        return LayoutData(
+            itemFrames: itemFrames,
+            itemBuckets: itemBuckets,
+            supplementaryAttrs: headerAttrs(numberOfSections: itemFrames.count, collectionView: collectionView),
+            decorationAttrs: decorationAttrs(in: dateInterval, numberOfSections: itemFrames.count, collectionView: collectionView),
+            dateInterval: dateInterval
+        )
+    }
+
+    private static func headerAttrs(numberOfSections: Int, collectionView: UICollectionView) -> [UICollectionViewLayoutAttributes] {
+        (0 ..< numberOfSections).map { section in
             let attrs = UICollectionViewLayoutAttributes(forSupplementaryViewOfKind: UICollectionView.elementKindSectionHeader, with: IndexPath(item: 0, section: section))
             attrs.frame = CGRect(
                 x: collectionView.contentOffset.x,
                 y: timelineHeight + CGFloat(section) * (sectionHeight + verticalSpacing),
                 width: channelHeaderWidth,
-                height: (section != snapshot.sectionIdentifiers.count - 1) ? sectionHeight + verticalSpacing : sectionHeight
+                height: (section != numberOfSections - 1) ? sectionHeight + verticalSpacing : sectionHeight
             )
             attrs.zIndex = 2
             return attrs
         }
+    }
 
+    private static func decorationAttrs(in dateInterval: DateInterval, numberOfSections: Int, collectionView: UICollectionView) -> [UICollectionViewLayoutAttributes] {
         let timelineAttr = TimelineLayoutAttributes(forDecorationViewOfKind: ElementKind.timeline.rawValue, with: IndexPath(item: 0, section: 0))
         timelineAttr.frame = CGRect(
             x: -timelinePadding,
@@ -146,14 +185,41 @@ final class ProgramGuideGridLayout: UICollectionViewLayout {
 
         let nowDate = Date()
         var decorationAttrs: [UICollectionViewLayoutAttributes] = [timelineAttr]
-        if !snapshot.sectionIdentifiers.isEmpty, dateInterval.contains(nowDate) {
+        if numberOfSections != 0, dateInterval.contains(nowDate) {
             let nowHeadAttr = nowArrowAttr(at: nowDate, in: dateInterval, collectionView: collectionView)
             decorationAttrs.append(nowHeadAttr)
 
             let nowLineAttr = nowLineAttr(at: nowDate, in: dateInterval, collectionView: collectionView)
             decorationAttrs.append(nowLineAttr)
         }
-        return LayoutData(layoutAttrs: layoutAttrs, supplementaryAttrs: headerAttrs, decorationAttrs: decorationAttrs, dateInterval: dateInterval)
+        return decorationAttrs
+    }
+
+    /// Time slots spanned by the specified horizontal range, limited to the specified date interval.
+    private static func slots(from minX: CGFloat, to maxX: CGFloat, in dateInterval: DateInterval) -> ClosedRange<Int> {
+        let origin = channelHeaderWidth + horizontalSpacing
+        let range = 0 ... dateInterval.duration * scale
+        let firstSlot = Int(((minX - origin).clamped(to: range) / slotWidth).rounded(.down))
+        let lastSlot = Int(((maxX - origin).clamped(to: range) / slotWidth).rounded(.down))
+        return firstSlot ... max(lastSlot, firstSlot)
+    }
+
+    /// Sections spanned by the specified vertical range.
+    private static func sections(from minY: CGFloat, to maxY: CGFloat, numberOfSections: Int) -> Range<Int> {
+        guard numberOfSections != 0 else { return 0 ..< 0 }
+        let range = 0 ... CGFloat(numberOfSections - 1) * (sectionHeight + verticalSpacing)
+        let firstSection = Int(((minY - timelineHeight).clamped(to: range) / (sectionHeight + verticalSpacing)).rounded(.down))
+        let lastSection = Int(((maxY - timelineHeight).clamped(to: range) / (sectionHeight + verticalSpacing)).rounded(.down))
+        return firstSection ..< max(lastSection, firstSection) + 1
+    }
+
+    private static func itemAttrs(at indexPath: IndexPath, in layoutData: LayoutData, collectionView: UICollectionView) -> UICollectionViewLayoutAttributes? {
+        guard indexPath.section < layoutData.numberOfSections else { return nil }
+        let frames = layoutData.itemFrames[indexPath.section]
+        guard indexPath.item < frames.count else { return nil }
+        let attrs = UICollectionViewLayoutAttributes(forCellWith: indexPath)
+        attrs.frame = adjustedFrame(frames[indexPath.item], in: collectionView)
+        return attrs
     }
 
     private static func xPosition(at date: Date, in dateInterval: DateInterval) -> CGFloat {
@@ -201,8 +267,7 @@ final class ProgramGuideGridLayout: UICollectionViewLayout {
 
     override init() {
         super.init()
-        Timer.publish(every: 10, on: .main, in: .common)
-            .autoconnect()
+        WallClock.shared.publisher(every: 10)
             .sink { [weak self] _ in
                 self?.invalidateLayout()
             }
@@ -214,13 +279,25 @@ final class ProgramGuideGridLayout: UICollectionViewLayout {
         fatalError("init(coder:) has not been implemented")
     }
 
+    override class var invalidationContextClass: AnyClass {
+        InvalidationContext.self
+    }
+
     override func prepare() {
         super.prepare()
 
         if let collectionView, let dataSource = collectionView.dataSource as? UICollectionViewDiffableDataSource<ProgramGuideDailyViewModel.Section, ProgramGuideDailyViewModel.Item> {
-            layoutData = Self.layoutData(from: dataSource.snapshot(), in: collectionView)
+            if needsLayoutData {
+                layoutData = Self.layoutData(from: dataSource.snapshot(), in: collectionView)
+                needsLayoutData = false
+            } else if let dateInterval = layoutData?.dateInterval, let numberOfSections = layoutData?.numberOfSections {
+                // Only sticky elements depend on the content offset
+                layoutData?.supplementaryAttrs = Self.headerAttrs(numberOfSections: numberOfSections, collectionView: collectionView)
+                layoutData?.decorationAttrs = Self.decorationAttrs(in: dateInterval, numberOfSections: numberOfSections, collectionView: collectionView)
+            }
         } else {
             layoutData = nil
+            needsLayoutData = true
         }
     }
 
@@ -228,6 +305,21 @@ final class ProgramGuideGridLayout: UICollectionViewLayout {
         true
     }
 
+    override func invalidationContext(forBoundsChange newBounds: CGRect) -> UICollectionViewLayoutInvalidationContext {
+        let context = super.invalidationContext(forBoundsChange: newBounds)
+        if let context = context as? InvalidationContext, let collectionView, newBounds.size == collectionView.bounds.size {
+            context.invalidatesBoundsOnly = true
+        }
+        return context
+    }
+
+    override func invalidateLayout(with context: UICollectionViewLayoutInvalidationContext) {
+        if context.invalidateEverything || context.invalidateDataSourceCounts || !((context as? InvalidationContext)?.invalidatesBoundsOnly ?? false) {
+            needsLayoutData = true
+        }
+        super.invalidateLayout(with: context)
+    }
+
     override var collectionViewContentSize: CGSize {
         guard let collectionView, let layoutData else { return .zero }
         return CGSize(
@@ -237,19 +329,40 @@ final class ProgramGuideGridLayout: UICollectionViewLayout {
     }
 
     override func layoutAttributesForElements(in rect: CGRect) -> [UICollectionViewLayoutAttributes]? {
-        guard let layoutData else { return nil }
-        let layoutAttrs = layoutData.layoutAttrs.filter { $0.frame.intersects(rect) }
-        let supplementaryAttrs = layoutData.supplementaryAttrs.filter { $0.frame.intersects(rect) }
+        guard let collectionView, let layoutData else { return nil }
+
+        let sections = Self.sections(from: rect.minY, to: rect.maxY, numberOfSections: layoutData.numberOfSections)
+        let slots = Self.slots(from: rect.minX, to: rect.maxX, in: layoutData.dateInterval)
+
+        var layoutAttrs = [UICollectionViewLayoutAttributes]()
+        for section in sections {
+            let buckets = layoutData.itemBuckets[section]
+            var items = Set<Int>()
+            for slot in slots {
+                if let bucketItems = buckets[slot] {
+                    items.formUnion(bucketItems)
+                }
+            }
+            for item in items.sorted() {
+                if let attrs = Self.itemAttrs(at: IndexPath(item: item, section: section), in: layoutData, collectionView: collectionView),
+                   attrs.frame.intersects(rect) {
+                    layoutAttrs.append(attrs)
+                }
+            }
+        }
+        let supplementaryAttrs = sections.map { layoutData.supplementaryAttrs[$0] }.filter { $0.frame.intersects(rect) }
         let decorationAttrs = layoutData.decorationAttrs.filter { $0.frame.intersects(rect) }
         return layoutAttrs + supplementaryAttrs + decorationAttrs
     }
 
     override func layoutAttributesForItem(at indexPath: IndexPath) -> UICollectionViewLayoutAttributes? {
-        layoutData?.layoutAttrs.first { $0.indexPath == indexPath }
+        guard let collectionView, let layoutData else { return nil }
+        return Self.itemAttrs(at: indexPath, in: layoutData, collectionView: collectionView)
     }
 
     override func layoutAttributesForSupplementaryView(ofKind elementKind: String, at indexPath: IndexPath) -> UICollectionViewLayoutAttributes? {
-        layoutData?.supplementaryAttrs.first { $0.indexPath == indexPath && $0.representedElementKind == elementKind }
+        guard elementKind == UICollectionView.elementKindSectionHeader, let layoutData, indexPath.section < layoutData.numberOfSections else { return nil }
+        return layoutData.supplementaryAttrs[indexPath.section]
     }
 
     override func layoutAttributesForDecorationView(ofKind elementKind: String, at indexPath: IndexPath) -> UICollectionViewLayoutAttributes? {
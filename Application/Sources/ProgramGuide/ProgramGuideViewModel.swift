@@ -100,10 +100,17 @@ final class ProgramGuideViewModel: ObservableObject {
 
     func switchToPreviousDay() {
         switchToDay(SRGDay(byAddingDays: -1, months: 0, years: 0, to: day))
+        prefetchDay(SRGDay(byAddingDays: -1, months: 0, years: 0, to: day))
     }
 
     func switchToNextDay() {
         switchToDay(SRGDay(byAddingDays: 1, months: 0, years: 0, to: day))
+        prefetchDay(SRGDay(byAddingDays: 1, months: 0, years: 0, to: day))
+    }
+
+    /// Load the day the user is likely to page to next, so that it can be displayed without waiting
+    private func prefetchDay(_ day: SRGDay) {
+        SRGDataProvider.current!.prefetchTvPrograms(day: day)
     }
 
     func switchToTonight() {
@@ -160,9 +167,7 @@ private extension ProgramGuideViewModel {
     // TODO: Once an IL request is available to get the channel list without any day, use this request and
     //       remove the day parameter.
     static func channels(for _: SRGVendor, mainProvider: Bool, day: SRGDay) -> AnyPublisher<[PlayChannel], Error> {
-        SRGDataProvider.current!.tvProgramsPublisher(day: day, mainProvider: mainProvider, minimal: true)
-            .map { $0.map(\.channel) }
-            .eraseToAnyPublisher()
+        SRGDataProvider.current!.tvChannelsPublisher(day: day, mainProvider: mainProvider)
     }
 
     static func data(for day: SRGDay, from data: Data) -> AnyPublisher<Data, Never> {
@@ -70,8 +70,7 @@ final class ProgramPreviewModel: ObservableObject {
     }
 
     init() {
-        Timer.publish(every: 10, on: .main, in: .common)
-            .autoconnect()
+        WallClock.shared.publisher(every: 10, boundary: { [weak self] in self?.program?.nextBoundary(after: Date()) })
             .assign(to: &$date)
     }
 }
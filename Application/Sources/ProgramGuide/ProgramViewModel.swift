@@ -34,8 +34,7 @@ final class ProgramViewModel: ObservableObject {
     private let eventEditViewDelegateObject = EventEditViewDelegateObject()
 
     init() {
-        Timer.publish(every: 10, on: .main, in: .common)
-            .autoconnect()
+        WallClock.shared.publisher(every: 10, boundary: { [weak self] in self?.nextProgramBoundary })
             .assign(to: &$date)
     }
 
@@ -55,6 +54,10 @@ final class ProgramViewModel: ObservableObject {
         data?.channel.wrappedValue
     }
 
+    private var nextProgramBoundary: Date? {
+        program?.nextBoundary(after: Date())
+    }
+
     private var isLive: Bool {
         guard let program else { return false }
         return (program.wrappedValue.startDate ... program.extendedEndDate).contains(date)
@@ -417,7 +420,7 @@ extension ProgramViewModel {
     private static func livestreamMediaPublisher(for channel: SRGChannel?) -> AnyPublisher<SRGMedia?, Never> {
         if let channel {
             Publishers.PublishAndRepeat(onOutputFrom: ApplicationSignal.wokenUp()) {
-                SRGDataProvider.current!.tvLivestreams(for: channel.vendor)
+                SRGDataProvider.current!.sharedTvLivestreams(for: channel.vendor)
                     .catch { _ in
                         Empty()
                     }
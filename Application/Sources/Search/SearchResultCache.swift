@@ -0,0 +1,102 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+import SRGDataProviderModel
+
+/**
+ *  Bounded in-memory cache of recent search results, so that searches repeated shortly afterwards (e.g. when typing,
+ *  deleting and retyping a query, or toggling settings back and forth) are displayed without network requests. Least
+ *  recently used results are discarded first.
+ *
+ *  Can be used from any thread.
+ */
+final class SearchResultCache {
+    static let shared = SearchResultCache()
+
+    private static let capacity = 20
+    private static let ttl: TimeInterval = 5 * 60
+
+    struct MediaResult {
+        let mediaUrns: [String]
+        let suggestions: [SRGSearchSuggestion]?
+    }
+
+    private struct Key: Equatable {
+        let query: String
+        let settings: MediaSearchSettings?
+    }
+
+    private struct Entry {
+        let key: Key
+        var mediaResult: MediaResult?
+        var shows: [SRGShow]?
+        var expirationDate: Date
+    }
+
+    // Most recently used entries last
+    private var entries = [Entry]()
+    private let lock = NSLock()
+
+    /**
+     *  Media search results (the first page) for a query and settings, if available.
+     */
+    func mediaResult(matchingQuery query: String, with settings: MediaSearchSettings?) -> MediaResult? {
+        synchronized {
+            entry(for: Key(query: query, settings: settings))?.mediaResult
+        }
+    }
+
+    func store(_ mediaResult: MediaResult, matchingQuery query: String, with settings: MediaSearchSettings?) {
+        synchronized {
+            update(Key(query: query, settings: settings)) { $0.mediaResult = mediaResult }
+        }
+    }
+
+    /**
+     *  Show search results for a query and settings, if available.
+     */
+    func shows(matchingQuery query: String, with settings: MediaSearchSettings?) -> [SRGShow]? {
+        synchronized {
+            entry(for: Key(query: query, settings: settings))?.shows
+        }
+    }
+
+    func store(_ shows: [SRGShow], matchingQuery query: String, with settings: MediaSearchSettings?) {
+        synchronized {
+            update(Key(query: query, settings: settings)) { $0.shows = shows }
+        }
+    }
+
+    private func synchronized<T>(_ block: () -> T) -> T {
+        lock.lock()
+        defer { lock.unlock() }
+        return block()
+    }
+
+    /// Return the entry for a key, if not expired, marking it as most recently used.
+    private func entry(for key: Key) -> Entry? {
+        guard let index = entries.firstIndex(where: { $0.key == key }) else { return nil }
+
+        let entry = entries.remove(at: index)
+        guard entry.expirationDate > Date() else { return nil }
+
+        entries.append(entry)
+        return entry
+    }
+
+    private func update(_ key: Key, with block: (inout Entry) -> Void) {
+        var entry = entries.firstIndex(where: { $0.key == key }).map { entries.remove(at: $0) } ?? Entry(key: key, expirationDate: Date())
+        if entry.expirationDate <= Date() {
+            entry = Entry(key: key, expirationDate: Date().addingTimeInterval(Self.ttl))
+        }
+        block(&entry)
+        entries.append(entry)
+
+        if entries.count > Self.capacity {
+            entries.removeFirst(entries.count - Self.capacity)
+        }
+    }
+}
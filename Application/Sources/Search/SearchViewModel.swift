@@ -25,8 +25,13 @@ final class SearchViewModel: ObservableObject {
         Publishers.CombineLatest($query.removeDuplicates(), $settings)
             .debounceAfterFirst(for: 0.3, scheduler: DispatchQueue.main)
             .map { [weak self, trigger] query, settings in
-                Publishers.PublishAndRepeat(onOutputFrom: self?.reloadSignal()) {
-                    Self.rows(matchingQuery: query, with: settings, trigger: trigger)
+                // Cached results are only used for the first search. Reloads (e.g. pull-to-refresh) must fetch fresh data.
+                var isReloading = false
+                return Publishers.PublishAndRepeat(onOutputFrom: self?.reloadSignal()) {
+                    defer {
+                        isReloading = true
+                    }
+                    return Self.rows(matchingQuery: query, with: settings, cached: !isReloading, trigger: trigger)
                         .map { Self.state(from: $0.rows, suggestions: $0.suggestions) }
                         .catch { error in
                             Just(State.failed(error: error))
@@ -128,6 +133,30 @@ extension SearchViewModel {
         case loadMore
         case reload
     }
+
+    /// Media search results received so far, with the URNs not already received before the latest page.
+    struct MediaPage {
+        let index: Int
+        let mediaUrns: [String]
+        let newMediaUrns: [String]
+        let suggestions: [SRGSearchSuggestion]?
+
+        private let mediaUrnSet: Set<String>
+
+        static var initial: Self {
+            Self(index: -1, mediaUrns: [], newMediaUrns: [], suggestions: nil, mediaUrnSet: [])
+        }
+
+        var isEmpty: Bool {
+            newMediaUrns.isEmpty
+        }
+
+        func next(with result: SearchResultCache.MediaResult) -> Self {
+            var mediaUrnSet = mediaUrnSet
+            let newMediaUrns = result.mediaUrns.filter { mediaUrnSet.insert($0).inserted }
+            return Self(index: index + 1, mediaUrns: mediaUrns + newMediaUrns, newMediaUrns: newMediaUrns, suggestions: result.suggestions, mediaUrnSet: mediaUrnSet)
+        }
+    }
 }
 
 // MARK: Publishers
@@ -149,33 +178,42 @@ private extension SearchViewModel {
         }
     }
 
-    static func searchResults(matchingQuery query: String, with settings: MediaSearchSettings, trigger: Trigger) -> AnyPublisher<(rows: [Row], suggestions: [SRGSearchSuggestion]?), Error> {
+    static func searchResults(matchingQuery query: String, with settings: MediaSearchSettings, cached: Bool, trigger: Trigger) -> AnyPublisher<(rows: [Row], suggestions: [SRGSearchSuggestion]?), Error> {
         if !ApplicationConfiguration.shared.areShowsUnavailable {
             if !query.isEmpty {
                 Publishers.CombineLatest(
-                    shows(matchingQuery: query, with: settings),
-                    medias(matchingQuery: query, with: settings, paginatedBy: trigger.signal(activatedBy: TriggerId.loadMore))
+                    shows(matchingQuery: query, with: settings, cached: cached),
+                    medias(matchingQuery: query, with: settings, cached: cached, paginatedBy: trigger.signal(activatedBy: TriggerId.loadMore))
                 )
                 .map { (rows: [$0, $1.row], suggestions: $1.suggestions) }
                 .eraseToAnyPublisher()
             } else {
-                medias(matchingQuery: query, with: settings, paginatedBy: trigger.signal(activatedBy: TriggerId.loadMore))
+                medias(matchingQuery: query, with: settings, cached: cached, paginatedBy: trigger.signal(activatedBy: TriggerId.loadMore))
                     .map { (rows: [$0.row], suggestions: $0.suggestions) }
                     .eraseToAnyPublisher()
             }
         } else {
-            medias(matchingQuery: query, with: nil /* Case of SWI; settings not supported */, paginatedBy: trigger.signal(activatedBy: TriggerId.loadMore))
+            medias(matchingQuery: query, with: nil /* Case of SWI; settings not supported */, cached: cached, paginatedBy: trigger.signal(activatedBy: TriggerId.loadMore))
                 .map { (rows: [$0.row], suggestions: $0.suggestions) }
                 .eraseToAnyPublisher()
         }
     }
 
-    static func shows(matchingQuery query: String, with settings: MediaSearchSettings) -> AnyPublisher<Row, Error> {
+    static func shows(matchingQuery query: String, with settings: MediaSearchSettings, cached: Bool) -> AnyPublisher<Row, Error> {
+        if cached, let shows = SearchResultCache.shared.shows(matchingQuery: query, with: settings) {
+            return Just(Row(section: .shows, items: shows.map { Item.show($0) }))
+                .setFailureType(to: Error.self)
+                .eraseToAnyPublisher()
+        }
+
         let vendor = ApplicationConfiguration.shared.vendor
         let pageSize = ApplicationConfiguration.shared.detailPageSize
         return SRGDataProvider.current!.shows(for: vendor, matchingQuery: query, mediaType: settings.mediaType, pageSize: pageSize, paginatedBy: nil)
             .map { output in
                 SRGDataProvider.current!.shows(withUrns: output.showUrns, pageSize: pageSize)
+                    .handleEvents(receiveOutput: { shows in
+                        SearchResultCache.shared.store(shows, matchingQuery: query, with: settings)
+                    })
                     .map { $0.map { Item.show($0) } }
             }
             .switchToLatest()
@@ -184,17 +222,59 @@ private extension SearchViewModel {
             .eraseToAnyPublisher()
     }
 
-    static func medias(matchingQuery query: String, with settings: MediaSearchSettings?, paginatedBy signal: Trigger.Signal) -> AnyPublisher<(row: Row, suggestions: [SRGSearchSuggestion]?), Error> {
+    /// Media search results are delivered page by page. The first page, if available from the cache (and `cached`), is
+    /// published without request. Requests only start when more results are needed, the first page being requested
+    /// again and skipped since it is already displayed. Only the first page is cached, as requests cannot resume at a
+    /// later page and each cached page would cost one more request on the next load. Only medias not already displayed
+    /// are appended to the list.
+    static func medias(matchingQuery query: String, with settings: MediaSearchSettings?, cached: Bool, paginatedBy signal: Trigger.Signal) -> AnyPublisher<(row: Row, suggestions: [SRGSearchSuggestion]?), Error> {
         let vendor = ApplicationConfiguration.shared.vendor
         let pageSize = ApplicationConfiguration.shared.detailPageSize
-        return SRGDataProvider.current!.medias(for: vendor, matchingQuery: query, with: settings?.requestSettings, pageSize: pageSize, paginatedBy: signal)
-            .map { output in
-                SRGDataProvider.current!.medias(withUrns: output.mediaUrns, pageSize: pageSize)
-                    .map { (items: $0.map { Item.media($0) }, suggestions: output.suggestions) }
+
+        let skipTrigger = Trigger()
+        let pagesPublisher = SRGDataProvider.current!.medias(
+            for: vendor,
+            matchingQuery: query,
+            with: settings?.requestSettings,
+            pageSize: pageSize,
+            paginatedBy: Publishers.Merge(signal, skipTrigger.signal(activatedBy: TriggerId.loadMore)).eraseToAnyPublisher()
+        )
+        .map { SearchResultCache.MediaResult(mediaUrns: $0.mediaUrns, suggestions: $0.suggestions) }
+
+        let resultsPublisher: AnyPublisher<SearchResultCache.MediaResult, Error> = if cached, let cachedResult = SearchResultCache.shared.mediaResult(matchingQuery: query, with: settings) {
+            Just(cachedResult)
+                .setFailureType(to: Error.self)
+                .append(
+                    signal
+                        .first()
+                        .setFailureType(to: Error.self)
+                        .flatMap { _ in pagesPublisher }
+                )
+                .eraseToAnyPublisher()
+        } else {
+            pagesPublisher
+                .eraseToAnyPublisher()
+        }
+
+        return resultsPublisher
+            .scan(MediaPage.initial) { $0.next(with: $1) }
+            .handleEvents(receiveOutput: { page in
+                if page.index == 0 {
+                    SearchResultCache.shared.store(SearchResultCache.MediaResult(mediaUrns: page.mediaUrns, suggestions: page.suggestions), matchingQuery: query, with: settings)
+                }
+                if page.isEmpty, page.index > 0 {
+                    // Already displayed page. Request the next one.
+                    DispatchQueue.main.async {
+                        skipTrigger.activate(for: TriggerId.loadMore)
+                    }
+                }
+            })
+            .flatMap(maxPublishers: .max(1)) { page in
+                MediaHydrationService.shared.medias(withUrns: page.newMediaUrns)
+                    .map { (items: $0.map { Item.media($0) }, suggestions: page.suggestions) }
             }
-            .switchToLatest()
             .scan((items: [], suggestions: nil)) {
-                (items: removeDuplicates(in: $0.items + $1.items), suggestions: $1.suggestions)
+                (items: $0.items + $1.items, suggestions: $1.suggestions)
             }
             .prepend((items: [Item.loading], suggestions: nil))
             .map { (row: Row(section: .medias, items: $0.items), suggestions: $0.suggestions) }
@@ -219,9 +299,9 @@ private extension SearchViewModel {
             .eraseToAnyPublisher()
     }
 
-    static func rows(matchingQuery query: String, with settings: MediaSearchSettings, trigger: Trigger) -> AnyPublisher<(rows: [Row], suggestions: [SRGSearchSuggestion]?), Error> {
+    static func rows(matchingQuery query: String, with settings: MediaSearchSettings, cached: Bool, trigger: Trigger) -> AnyPublisher<(rows: [Row], suggestions: [SRGSearchSuggestion]?), Error> {
         if isSearching(with: query, settings: settings) {
-            searchResults(matchingQuery: query, with: settings, trigger: trigger)
+            searchResults(matchingQuery: query, with: settings, cached: cached, trigger: trigger)
         } else {
             searchSuggestion()
         }
@@ -8,7 +8,6 @@ import Combine
 import SRGIdentity
 import SRGUserData
 import StoreKit
-import YYWebImage
 
 // MARK: View model
 
@@ -44,31 +43,17 @@ final class SettingsViewModel: ObservableObject {
             #endif
         }
 
-        ThrottledSignal.preferenceUpdates()
-            .prepend(())
-            // swiftlint:disable:next empty_count
-            .map { FavoritesShowURNs().count != 0 }
+        UserDataCache.shared.favoriteCountPublisher()
+            .map { $0 != 0 }
             .assign(to: &$hasFavorites)
 
-        ThrottledSignal.historyUpdates()
-            .prepend(())
-            .map { [weak self] _ in
-                SRGDataProvider.current!.historyEntriesPublisher()
-                    .map { !$0.isEmpty }
-                    .replaceError(with: self?.hasHistoryEntries ?? false)
-            }
-            .switchToLatest()
+        UserDataCache.shared.historyEntryCountPublisher()
+            .map { $0 != 0 }
             .receive(on: DispatchQueue.main)
             .assign(to: &$hasHistoryEntries)
 
-        ThrottledSignal.watchLaterUpdates()
-            .prepend(())
-            .map { [weak self] _ in
-                SRGDataProvider.current!.laterEntriesPublisher()
-                    .map { !$0.isEmpty }
-                    .replaceError(with: self?.hasWatchLaterItems ?? false)
-            }
-            .switchToLatest()
+        UserDataCache.shared.watchLaterEntryCountPublisher()
+            .map { $0 != 0 }
             .receive(on: DispatchQueue.main)
             .assign(to: &$hasWatchLaterItems)
     }
@@ -220,11 +205,7 @@ final class SettingsViewModel: ObservableObject {
 
     func clearWebCache() {
         URLCache.shared.removeAllCachedResponses()
-
-        if let cache = YYWebImageManager.shared().cache {
-            cache.memoryCache.removeAllObjects()
-            cache.diskCache.removeAllObjects()
-        }
+        ImageLoader.removeAllCachedImages()
     }
 
     func clearVectorImageCache() {
@@ -17,8 +17,7 @@ final class DiskInfoFooterViewModel: ObservableObject {
     }
 
     init() {
-        Timer.publish(every: 10, on: .main, in: .common)
-            .autoconnect()
+        WallClock.shared.publisher(every: 10)
             .map { _ in }
             .prepend(())
             .compactMap {
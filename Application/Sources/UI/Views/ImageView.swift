@@ -13,9 +13,12 @@ import SwiftUI
 /**
  *  An image view supporting content modes for image scaling and alignment.
  *
- *  Remark: This cannot be implemented with Nuke resizing processors because the image size is usually not reliably known
- *          when SwiftUI builds the view for the first time. Instead we use SwiftUI frames to size the content and position
- *          it afterwards.
+ *  Remark: Content is sized and positioned with SwiftUI frames, since the image size is not known before the image has
+ *          been loaded. When the content mode scales the image, the request also includes a Nuke `Resize` processor
+ *          targeting the frame size rounded up to 20 pt steps (preserving the aspect ratio, never upscaling), so that
+ *          decoded bitmaps are not larger than needed. When the frame grows past a step a new request is made, and the
+ *          image is decoded again from the cached original data, replacing the displayed one once available. Views whose
+ *          size changes continuously should use a content mode without scaling.
  *
  *  Behavior: h-exp, v-exp
  */
@@ -152,6 +155,41 @@ struct ImageView: View {
         )
     }
 
+    /// Frame sizes are rounded up to multiples of this value (in points), so that small layout differences do not
+    /// lead to distinct requests and cached bitmaps
+    private static let downsamplingSizeStep: CGFloat = 20
+
+    /**
+     *  Request for the source, downsampled to the specified size if the image is scaled to fit the frame.
+     */
+    private static func request(for source: ImageRequestConvertible?, contentMode: ContentMode, size: CGSize) -> ImageRequest? {
+        guard var request = source?.asImageRequest() else { return nil }
+        guard let resizeContentMode = resizeContentMode(for: contentMode) else { return request }
+
+        let downsamplingSize = CGSize(
+            width: (size.width / downsamplingSizeStep).rounded(.up) * downsamplingSizeStep,
+            height: (size.height / downsamplingSizeStep).rounded(.up) * downsamplingSizeStep
+        )
+        request.processors.append(ImageProcessors.Resize(size: downsamplingSize, unit: .points, contentMode: resizeContentMode, crop: false, upscale: false))
+        return request
+    }
+
+    /**
+     *  Downsampling mode matching a content mode, `nil` if the image is displayed with its own size.
+     */
+    private static func resizeContentMode(for contentMode: ContentMode) -> ImageProcessors.Resize.ContentMode? {
+        switch contentMode {
+        case .aspectFit, .aspectFitTop, .aspectFitBottom, .aspectFitLeft, .aspectFitRight,
+             .aspectFitTopLeft, .aspectFitTopRight, .aspectFitBottomLeft, .aspectFitBottomRight:
+            .aspectFit
+        case .aspectFill, .fill, .aspectFillTop, .aspectFillBottom, .aspectFillLeft, .aspectFillRight,
+             .aspectFillTopLeft, .aspectFillTopRight, .aspectFillBottomLeft, .aspectFillBottomRight, .aspectFillFocused:
+            .aspectFill
+        case .center, .top, .bottom, .left, .right, .topLeft, .topRight, .bottomLeft, .bottomRight:
+            nil
+        }
+    }
+
     init(source: ImageRequestConvertible?, contentMode: ContentMode = .aspectFit) {
         self.source = source
         self.contentMode = contentMode
@@ -159,54 +197,62 @@ struct ImageView: View {
 
     var body: some View {
         GeometryReader { geometry in
-            LazyImage(source: source) { state in
-                if let image = state.image, let imageContainer = state.imageContainer {
-                    switch contentMode {
-                    case .aspectFit:
-                        image
-                            .resizingMode(.aspectFit)
-                    case .aspectFill:
-                        image
-                            .resizingMode(.aspectFill)
-                    case .center:
-                        image
-                            .resizingMode(.center)
-                    case .fill:
-                        image
-                            .resizingMode(.fill)
-                    case .top, .bottom, .left, .right,
-                         .topLeft, .topRight, .bottomLeft, .bottomRight:
-                        image
-                            .frame(size: imageContainer.image.size)
-                            .frame(size: geometry.size, alignment: Self.alignment(for: contentMode))
-                    case .aspectFitTop, .aspectFitBottom, .aspectFitLeft, .aspectFitRight,
-                         .aspectFitTopLeft, .aspectFitTopRight, .aspectFitBottomLeft, .aspectFitBottomRight:
-                        image
-                            .resizingMode(.fill)
-                            .frame(size: Self.fitSize(for: imageContainer, in: geometry))
-                            .frame(size: geometry.size, alignment: Self.alignment(for: contentMode))
-                    case .aspectFillTop, .aspectFillBottom, .aspectFillLeft, .aspectFillRight,
-                         .aspectFillTopLeft, .aspectFillTopRight, .aspectFillBottomLeft, .aspectFillBottomRight:
-                        image
-                            .resizingMode(.fill)
-                            .frame(size: Self.fillSize(for: imageContainer, in: geometry))
-                            .frame(size: geometry.size, alignment: Self.alignment(for: contentMode))
-                    case let .aspectFillFocused(relativeWidth: relativeWidth, relativeHeight: relativeHeight):
-                        let fillSize = Self.fillSize(for: imageContainer, in: geometry)
-                        let targetSize = geometry.size
-                        let focalPoint = CGPoint(x: fillSize.width * relativeWidth, y: fillSize.height * relativeHeight)
-                        image
-                            .resizingMode(.fill)
-                            .frame(size: fillSize)
-                            .frame(size: targetSize, alignment: Self.alignment(for: contentMode))
-                            .offset(Self.offset(forFocalPoint: focalPoint, targetSize: targetSize, fillSize: fillSize))
-                    }
-                } else {
-                    Color.placeholder
+            if geometry.size.width != 0, geometry.size.height != 0 {
+                image(in: geometry)
+            } else {
+                Color.placeholder
+            }
+        }
+    }
+
+    private func image(in geometry: GeometryProxy) -> some View {
+        LazyImage(source: Self.request(for: source, contentMode: contentMode, size: geometry.size)) { state in
+            if let image = state.image, let imageContainer = state.imageContainer {
+                switch contentMode {
+                case .aspectFit:
+                    image
+                        .resizingMode(.aspectFit)
+                case .aspectFill:
+                    image
+                        .resizingMode(.aspectFill)
+                case .center:
+                    image
+                        .resizingMode(.center)
+                case .fill:
+                    image
+                        .resizingMode(.fill)
+                case .top, .bottom, .left, .right,
+                     .topLeft, .topRight, .bottomLeft, .bottomRight:
+                    image
+                        .frame(size: imageContainer.image.size)
+                        .frame(size: geometry.size, alignment: Self.alignment(for: contentMode))
+                case .aspectFitTop, .aspectFitBottom, .aspectFitLeft, .aspectFitRight,
+                     .aspectFitTopLeft, .aspectFitTopRight, .aspectFitBottomLeft, .aspectFitBottomRight:
+                    image
+                        .resizingMode(.fill)
+                        .frame(size: Self.fitSize(for: imageContainer, in: geometry))
+                        .frame(size: geometry.size, alignment: Self.alignment(for: contentMode))
+                case .aspectFillTop, .aspectFillBottom, .aspectFillLeft, .aspectFillRight,
+                     .aspectFillTopLeft, .aspectFillTopRight, .aspectFillBottomLeft, .aspectFillBottomRight:
+                    image
+                        .resizingMode(.fill)
+                        .frame(size: Self.fillSize(for: imageContainer, in: geometry))
+                        .frame(size: geometry.size, alignment: Self.alignment(for: contentMode))
+                case let .aspectFillFocused(relativeWidth: relativeWidth, relativeHeight: relativeHeight):
+                    let fillSize = Self.fillSize(for: imageContainer, in: geometry)
+                    let targetSize = geometry.size
+                    let focalPoint = CGPoint(x: fillSize.width * relativeWidth, y: fillSize.height * relativeHeight)
+                    image
+                        .resizingMode(.fill)
+                        .frame(size: fillSize)
+                        .frame(size: targetSize, alignment: Self.alignment(for: contentMode))
+                        .offset(Self.offset(forFocalPoint: focalPoint, targetSize: targetSize, fillSize: fillSize))
                 }
+            } else {
+                Color.placeholder
             }
-            .clipped()
         }
+        .clipped()
     }
 }
 
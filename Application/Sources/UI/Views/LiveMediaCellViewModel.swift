@@ -19,8 +19,8 @@ final class LiveMediaCellViewModel: ObservableObject {
     private var channelObserver: Any?
 
     init() {
-        Timer.publish(every: 10, on: .main, in: .common)
-            .autoconnect()
+        // Also update when the current program ends
+        WallClock.shared.publisher(every: 10, boundary: { [weak self] in self?.program?.endDate })
             .assign(to: &$date)
     }
 
@@ -27,7 +27,7 @@ final class MediaVisualViewModel: ObservableObject {
             .assign(to: &$progress)
     }
 
-    func imageUrl(for size: SRGImageSize, forceDefaultAspectRatio: Bool) -> URL? {
+    static func imageUrl(for media: SRGMedia?, size: SRGImageSize, forceDefaultAspectRatio: Bool) -> URL? {
         if ApplicationConfiguration.shared.arePodcastImagesEnabled, !forceDefaultAspectRatio, media?.mediaType == .audio, media?.show?.shouldFallbackToPodcastImage == false {
             url(for: media?.show?.podcastImage, size: size)
         } else {
@@ -35,6 +35,10 @@ final class MediaVisualViewModel: ObservableObject {
         }
     }
 
+    func imageUrl(for size: SRGImageSize, forceDefaultAspectRatio: Bool) -> URL? {
+        Self.imageUrl(for: media, size: size, forceDefaultAspectRatio: forceDefaultAspectRatio)
+    }
+
     var availabilityBadgeProperties: MediaDescription.BadgeProperties? {
         guard let media else { return nil }
         return MediaDescription.availabilityBadgeProperties(for: media)
@@ -140,7 +140,7 @@ enum ShowCellSize {
         imageVariant == .default || imageVariant == .podcast ? constant(iOS: 32, tvOS: 45) : 0
     }
 
-    fileprivate static func aspectRatio(for imageVariant: SRGImageVariant, isSwimlane: Bool) -> CGFloat {
+    static func aspectRatio(for imageVariant: SRGImageVariant, isSwimlane: Bool) -> CGFloat {
         switch imageVariant {
         case .poster:
             2 / 3
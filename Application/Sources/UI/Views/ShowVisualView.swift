@@ -39,7 +39,7 @@ struct ShowVisualView: View {
             .background(Color.thumbnailBackground)
     }
 
-    private var imageUrl: URL? {
+    static func imageUrl(for show: SRGShow?, size: SRGImageSize, imageVariant: SRGImageVariant = .default, aspectRatio: CGFloat = 16 / 9) -> URL? {
         switch imageVariant {
         case .poster:
             url(for: show?.posterImage, size: size)
@@ -53,6 +53,10 @@ struct ShowVisualView: View {
             url(for: show?.image, size: size)
         }
     }
+
+    private var imageUrl: URL? {
+        Self.imageUrl(for: show, size: size, imageVariant: imageVariant, aspectRatio: aspectRatio)
+    }
 }
 
 // MARK: Preview
@@ -51,6 +51,11 @@ OBJC_EXPORT NSString * _Nullable UserNotificationTypeString(UserNotificationType
  */
 @property (class, nonatomic, readonly) NSArray<UserNotification *> *unreadNotifications;
 
+/**
+ *  Number of currently unread notifications (cheaper than counting `unreadNotifications`).
+ */
+@property (class, nonatomic, readonly) NSUInteger unreadNotificationCount;
+
 /**
  *  Save a new notification or update an existing one.
  *
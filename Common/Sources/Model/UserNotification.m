@@ -11,6 +11,9 @@
 
 @import libextobjc;
 
+#include <fcntl.h>
+#include <sys/file.h>
+
 NSString * const UserNotificationsDidChangeNotification = @"UserNotificationsDidChangeNotification";
 
 static NSValueTransformer *NotificationTypeTransformer(void);
@@ -25,6 +28,23 @@ static NSString *NotificationDescriptionForType(UserNotificationType notificatio
     return s_descriptions[@(notificationType)];
 }
 
+// Notifications are stored as a snapshot (binary property list) and a log of notifications saved since the snapshot was
+// written. Each log record is a binary property list of a single notification dictionary, prefixed with its length. The
+// log is compacted into the snapshot when it grows too large. Both files are shared with the notification service
+// extension, which is why the in-memory index is reloaded when files are modified by another process. Files are
+// accessed under a file lock, so that the application and the extension never write concurrently, and never write
+// without having loaded the changes made by the other process first.
+
+static const NSUInteger kLogCompactionThreshold = 50;
+
+// Notifications sorted by descending date, with associated index and unread counter
+static NSMutableArray<UserNotification *> *s_notifications;
+static NSMutableDictionary<NSString *, UserNotification *> *s_notificationsByIdentifier;
+static NSUInteger s_unreadNotificationCount;
+
+static NSUInteger s_logRecordCount;
+static NSString *s_storeSignature;
+
 @interface UserNotification ()
 
 @property (nonatomic, copy) NSString *identifier;
@@ -46,90 +66,341 @@ static NSString *NotificationDescriptionForType(UserNotificationType notificatio
 
 + (NSArray<UserNotification *> *)notifications
 {
-    NSMutableArray<UserNotification *> *notificationsArray = [NSMutableArray array];
-    NSArray *notificationsPlistArray = [NSArray arrayWithContentsOfURL:[self notificationsFilePath]];
-    [notificationsPlistArray enumerateObjectsUsingBlock:^(id  _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
-        if ([obj isKindOfClass:NSDictionary.class]) {
-            NSDictionary *notificationDictionary = (NSDictionary *)obj;
-            UserNotification *notification = [[UserNotification alloc] initWithDictionary:notificationDictionary];
-            if (notification) {
-                [notificationsArray addObject:notification];
+    @synchronized (self) {
+        [self performWithStoreLockExclusive:NO block:^{
+            [self loadStoreIfNeeded];
+        }];
+        [self pruneExpiredNotifications];
+        return s_notifications.copy;
+    }
+}
+
++ (NSArray<UserNotification *> *)unreadNotifications
+{
+    @synchronized (self) {
+        [self performWithStoreLockExclusive:NO block:^{
+            [self loadStoreIfNeeded];
+        }];
+        [self pruneExpiredNotifications];
+        if (s_unreadNotificationCount == 0) {
+            return @[];
+        }
+        
+        NSPredicate *predicate = [NSPredicate predicateWithFormat:@"%K == %@", @keypath(UserNotification.new, read), @NO];
+        return [s_notifications filteredArrayUsingPredicate:predicate];
+    }
+}
+
++ (NSUInteger)unreadNotificationCount
+{
+    @synchronized (self) {
+        [self performWithStoreLockExclusive:NO block:^{
+            [self loadStoreIfNeeded];
+        }];
+        [self pruneExpiredNotifications];
+        return s_unreadNotificationCount;
+    }
+}
+
++ (void)saveNotification:(UserNotification *)notification read:(BOOL)read
+{
+    __block BOOL saved = NO;
+    
+    @synchronized (self) {
+        [self performWithStoreLockExclusive:YES block:^{
+            // Load changes made by the other process first, so that they are neither lost nor hidden from the index
+            [self loadStoreIfNeeded];
+            
+            UserNotification *originalNotification = s_notificationsByIdentifier[notification.identifier];
+            if (originalNotification) {
+                BOOL originalRead = originalNotification.read;
+                [self removeIndexedNotification:originalNotification];
+                
+                // Flag a notification unread again is not allowed.
+                if (read && ! originalRead) {
+                    notification.read = YES;
+                }
+            }
+            [self insertIndexedNotification:notification];
+            
+            if (s_logRecordCount >= kLogCompactionThreshold) {
+                saved = [self writeSnapshot];
             }
             else {
-                PlayLogError(@"notifications", @"A notification could not be loaded and was skipped.");
+                saved = [self appendLogRecordForNotification:notification];
+            }
+        }];
+    }
+    
+    if (saved) {
+        [NSNotificationCenter.defaultCenter postNotificationName:UserNotificationsDidChangeNotification object:nil];
+    }
+}
+
++ (void)saveNotifications:(NSArray<UserNotification *> *)notifications
+{
+    __block BOOL saved = NO;
+    
+    @synchronized (self) {
+        [self performWithStoreLockExclusive:YES block:^{
+            [self resetIndex];
+            for (UserNotification *notification in notifications) {
+                [self removeIndexedNotification:s_notificationsByIdentifier[notification.identifier]];
+                [self insertIndexedNotification:notification];
             }
+            saved = [self writeSnapshot];
+        }];
+    }
+    
+    if (saved) {
+        [NSNotificationCenter.defaultCenter postNotificationName:UserNotificationsDidChangeNotification object:nil];
+    }
+}
+
+#pragma mark Store
+
++ (NSURL *)notificationsFilePath
+{
+    return [[NSFileManager.play_applicationGroupContainerURL URLByAppendingPathComponent:@"Library"] URLByAppendingPathComponent:@"notifications.plist"];
+}
+
++ (NSURL *)notificationsLogFilePath
+{
+    return [[NSFileManager.play_applicationGroupContainerURL URLByAppendingPathComponent:@"Library"] URLByAppendingPathComponent:@"notifications.log"];
+}
+
++ (NSURL *)notificationsLockFilePath
+{
+    return [[NSFileManager.play_applicationGroupContainerURL URLByAppendingPathComponent:@"Library"] URLByAppendingPathComponent:@"notifications.lock"];
+}
+
+// Execute a block while holding the store file lock, shared between the application and the extension. The lock is
+// exclusive for writes, and shared for reads.
++ (void)performWithStoreLockExclusive:(BOOL)exclusive block:(void (NS_NOESCAPE ^)(void))block
+{
+    int fileDescriptor = open([self notificationsLockFilePath].fileSystemRepresentation, O_RDONLY | O_CREAT, 0644);
+    if (fileDescriptor == -1) {
+        PlayLogError(@"notifications", @"Could not open the notifications lock file. Reason: %s", strerror(errno));
+        block();
+        return;
+    }
+    
+    flock(fileDescriptor, exclusive ? LOCK_EX : LOCK_SH);
+    block();
+    flock(fileDescriptor, LOCK_UN);
+    close(fileDescriptor);
+}
+
++ (NSComparator)notificationComparator
+{
+    return ^NSComparisonResult(UserNotification * _Nonnull notification1, UserNotification * _Nonnull notification2) {
+        NSComparisonResult dateResult = [notification2.date compare:notification1.date];
+        if (dateResult != NSOrderedSame) {
+            return dateResult;
         }
-    }];
+        return [notification2.identifier compare:notification1.identifier];
+    };
+}
+
+// Cheap signature of the files on disk, used to detect changes made by another process
++ (NSString *)currentStoreSignature
+{
+    NSDictionary<NSFileAttributeKey, id> *snapshotAttributes = [NSFileManager.defaultManager attributesOfItemAtPath:[self notificationsFilePath].path error:NULL];
+    NSDictionary<NSFileAttributeKey, id> *logAttributes = [NSFileManager.defaultManager attributesOfItemAtPath:[self notificationsLogFilePath].path error:NULL];
+    return [NSString stringWithFormat:@"%@_%@_%@_%@", @(snapshotAttributes.fileModificationDate.timeIntervalSinceReferenceDate), @(snapshotAttributes.fileSize),
+            @(logAttributes.fileModificationDate.timeIntervalSinceReferenceDate), @(logAttributes.fileSize)];
+}
+
++ (void)resetIndex
+{
+    s_notifications = [NSMutableArray array];
+    s_notificationsByIdentifier = [NSMutableDictionary dictionary];
+    s_unreadNotificationCount = 0;
+}
+
++ (void)insertIndexedNotification:(UserNotification *)notification
+{
+    NSUInteger index = [s_notifications indexOfObject:notification
+                                        inSortedRange:NSMakeRange(0, s_notifications.count)
+                                              options:NSBinarySearchingInsertionIndex
+                                      usingComparator:[self notificationComparator]];
+    [s_notifications insertObject:notification atIndex:index];
+    s_notificationsByIdentifier[notification.identifier] = notification;
+    if (! notification.read) {
+        s_unreadNotificationCount++;
+    }
+}
+
++ (void)removeIndexedNotification:(UserNotification *)notification
+{
+    if (! notification) {
+        return;
+    }
     
-    NSDate *currentDate = NSDate.date;
+    NSUInteger index = [s_notifications indexOfObject:notification
+                                        inSortedRange:NSMakeRange(0, s_notifications.count)
+                                              options:NSBinarySearchingFirstEqual
+                                      usingComparator:[self notificationComparator]];
+    if (index != NSNotFound) {
+        [s_notifications removeObjectAtIndex:index];
+    }
+    else {
+        [s_notifications removeObject:notification];
+    }
+    [s_notificationsByIdentifier removeObjectForKey:notification.identifier];
+    if (! notification.read) {
+        s_unreadNotificationCount--;
+    }
+}
+
++ (void)pruneExpiredNotifications
+{
     NSDateComponents *dateComponents = [[NSDateComponents alloc] init];
-    [dateComponents setDay:-14];
-    NSDate *fourteenDaysAgo = [NSCalendar.srg_defaultCalendar dateByAddingComponents:dateComponents toDate:currentDate options:0];
-    NSPredicate *predicate = [NSPredicate predicateWithFormat:@"%K >= %@", @keypath(UserNotification.new, date), fourteenDaysAgo];
-    return [notificationsArray filteredArrayUsingPredicate:predicate];
+    dateComponents.day = -14;
+    NSDate *fourteenDaysAgo = [NSCalendar.srg_defaultCalendar dateByAddingComponents:dateComponents toDate:NSDate.date options:0];
+    
+    // Notifications are sorted by descending date, expired ones are at the end
+    while (s_notifications.count != 0 && [s_notifications.lastObject.date compare:fourteenDaysAgo] == NSOrderedAscending) {
+        [self removeIndexedNotification:s_notifications.lastObject];
+    }
 }
 
-+ (NSArray<UserNotification *> *)unreadNotifications
++ (UserNotification *)notificationFromPropertyList:(id)propertyList
 {
-    NSPredicate *predicate = [NSPredicate predicateWithFormat:@"%K == %@", @keypath(UserNotification.new, read), @NO];
-    return [UserNotification.notifications filteredArrayUsingPredicate:predicate];
+    if (! [propertyList isKindOfClass:NSDictionary.class]) {
+        return nil;
+    }
+    
+    UserNotification *notification = [[UserNotification alloc] initWithDictionary:propertyList];
+    if (! notification.identifier || ! notification.date) {
+        PlayLogError(@"notifications", @"A notification could not be loaded and was skipped.");
+        return nil;
+    }
+    return notification;
 }
 
-+ (void)saveNotification:(UserNotification *)notification read:(BOOL)read
++ (void)loadStoreIfNeeded
 {
-    NSArray<UserNotification *> *notifications = [self notifications];
+    NSString *storeSignature = [self currentStoreSignature];
+    if (s_notifications && [storeSignature isEqualToString:s_storeSignature]) {
+        return;
+    }
     
-    NSInteger index = [notifications indexOfObject:notification];
-    if (index != NSNotFound) {
-        // Flag a notification unread again is not allowed.
-        UserNotification *originalNotification = notifications[index];
-        if (read && ! originalNotification.read) {
-            notification.read = YES;
+    [self resetIndex];
+    
+    NSArray *notificationsPlistArray = [NSArray arrayWithContentsOfURL:[self notificationsFilePath]];
+    for (id notificationDictionary in notificationsPlistArray) {
+        UserNotification *notification = [self notificationFromPropertyList:notificationDictionary];
+        if (notification) {
+            [self removeIndexedNotification:s_notificationsByIdentifier[notification.identifier]];
+            [self insertIndexedNotification:notification];
         }
-        NSMutableArray<UserNotification *> *updatedNotifications = notifications.mutableCopy;
-        [updatedNotifications replaceObjectAtIndex:index withObject:notification];
-        notifications = updatedNotifications.copy;
     }
-    else {
-        notifications = [notifications arrayByAddingObject:notification];
+    
+    // Replay the log, whose records update or insert notifications
+    s_logRecordCount = 0;
+    NSData *logData = [NSData dataWithContentsOfURL:[self notificationsLogFilePath]];
+    NSUInteger offset = 0;
+    while (offset + sizeof(uint32_t) <= logData.length) {
+        uint32_t length = 0;
+        [logData getBytes:&length range:NSMakeRange(offset, sizeof(uint32_t))];
+        length = CFSwapInt32LittleToHost(length);
+        offset += sizeof(uint32_t);
+        
+        // Ignore a truncated last record
+        if (offset + length > logData.length) {
+            break;
+        }
+        
+        NSData *recordData = [logData subdataWithRange:NSMakeRange(offset, length)];
+        offset += length;
+        
+        id propertyList = [NSPropertyListSerialization propertyListWithData:recordData options:NSPropertyListImmutable format:NULL error:NULL];
+        UserNotification *notification = [self notificationFromPropertyList:propertyList];
+        if (notification) {
+            [self removeIndexedNotification:s_notificationsByIdentifier[notification.identifier]];
+            [self insertIndexedNotification:notification];
+        }
+        s_logRecordCount++;
     }
     
-    NSSortDescriptor *dateSortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@keypath(UserNotification.new, date) ascending:NO];
-    NSSortDescriptor *identifierSortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@keypath(UserNotification.new, identifier) ascending:NO];
-    notifications = [notifications sortedArrayUsingDescriptors:@[dateSortDescriptor, identifierSortDescriptor]];
-    [self saveNotifications:notifications];
+    s_storeSignature = storeSignature;
 }
 
-+ (NSURL *)notificationsFilePath
++ (BOOL)appendLogRecordForNotification:(UserNotification *)notification
 {
-    return [[NSFileManager.play_applicationGroupContainerURL URLByAppendingPathComponent:@"Library"] URLByAppendingPathComponent:@"notifications.plist"];
+    NSError *plistError = nil;
+    NSData *recordData = [NSPropertyListSerialization dataWithPropertyList:notification.dictionary
+                                                                    format:NSPropertyListBinaryFormat_v1_0
+                                                                   options:0
+                                                                     error:&plistError];
+    if (plistError) {
+        PlayLogError(@"notifications", @"Could not save notifications data. Reason: %@", plistError);
+        return NO;
+    }
+    
+    NSURL *logFileURL = [self notificationsLogFilePath];
+    if (! [NSFileManager.defaultManager fileExistsAtPath:logFileURL.path]) {
+        [NSFileManager.defaultManager createFileAtPath:logFileURL.path contents:nil attributes:nil];
+    }
+    
+    NSError *writeError = nil;
+    NSFileHandle *fileHandle = [NSFileHandle fileHandleForWritingToURL:logFileURL error:&writeError];
+    if (fileHandle) {
+        uint32_t length = CFSwapInt32HostToLittle((uint32_t)recordData.length);
+        NSMutableData *data = [NSMutableData dataWithBytes:&length length:sizeof(uint32_t)];
+        [data appendData:recordData];
+        
+        if ([fileHandle seekToEndReturningOffset:NULL error:&writeError]) {
+            [fileHandle writeData:data error:&writeError];
+        }
+        [fileHandle closeAndReturnError:NULL];
+    }
+    
+    if (writeError) {
+        PlayLogError(@"notifications", @"Could not save notifications data. Reason: %@", writeError);
+        
+        // Fallback to a full snapshot
+        return [self writeSnapshot];
+    }
+    
+    // Changes made by the other process were loaded before appending, under the store lock
+    s_logRecordCount++;
+    s_storeSignature = [self currentStoreSignature];
+    return YES;
 }
 
-+ (void)saveNotifications:(NSArray<UserNotification *> *)notifications
++ (BOOL)writeSnapshot
 {
+    [self pruneExpiredNotifications];
+    
     NSMutableArray<NSDictionary *> *notificationsArray = [NSMutableArray array];
-    [notifications enumerateObjectsUsingBlock:^(UserNotification * _Nonnull notification, NSUInteger idx, BOOL * _Nonnull stop) {
+    for (UserNotification *notification in s_notifications) {
         [notificationsArray addObject:notification.dictionary];
-    }];
+    }
     
     NSError *plistError = nil;
     NSData *plistData = [NSPropertyListSerialization dataWithPropertyList:notificationsArray
-                                                                   format:NSPropertyListXMLFormat_v1_0
+                                                                   format:NSPropertyListBinaryFormat_v1_0
                                                                   options:0
                                                                     error:&plistError];
     if (plistError) {
         PlayLogError(@"notifications", @"Could not save notifications data. Reason: %@", plistError);
-        return;
+        return NO;
     }
     
     NSError *writeError = nil;
     [plistData writeToURL:[self notificationsFilePath] options:NSDataWritingAtomic error:&writeError];
     if (writeError) {
         PlayLogError(@"notifications", @"Could not save notifications data. Reason: %@", writeError);
+        return NO;
     }
-    else {
-        [NSNotificationCenter.defaultCenter postNotificationName:UserNotificationsDidChangeNotification object:nil];
-    }
+    
+    // The log cannot be modified by the other process in between, since the store lock is held
+    [NSFileManager.defaultManager removeItemAtURL:[self notificationsLogFilePath] error:NULL];
+    s_logRecordCount = 0;
+    s_storeSignature = [self currentStoreSignature];
+    return YES;
 }
 
 #pragma mark Object lifecycle
@@ -29,6 +29,8 @@ class AppDelegate: UIResponder {
 
 extension AppDelegate: UIApplicationDelegate {
     func application(_ application: UIApplication, didFinishLaunchingWithOptions _: [UIApplication.LaunchOptionsKey: Any]?) -> Bool {
+        ImageLoader.setup()
+
         PlayApplicationRunOnce({ completionHandler in
             PlayFirebaseConfiguration.clearCache()
             completionHandler(true)